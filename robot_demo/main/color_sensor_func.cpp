@@ -1,63 +1,722 @@
-/* TCS3200 color sensor. Returns dominant color as string. */
+/* TCS3200 color sensor. Adaptive scaling, clear-channel fast path, nearest-centroid classifier with EEPROM calibration. */
 #include "color_sensor_func.h"
+#include "flight_recorder.h"
+#include "log_sink.h"
+#include "eeprom_layout.h"
+#include "crc16.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+  #define LUT_READ(addr) pgm_read_byte(addr)
+#else
+  #ifndef PROGMEM
+    #define PROGMEM
+  #endif
+  #define LUT_READ(addr) (*(const uint8_t*)(addr))
+#endif
+#include "color_lut.h"
+
+// ============ CALIBRATION STATE ============
+// Stored as raw mean periods so the feature math can change without a
+// re-calibration; centroids are derived from them on load.
+struct ColorCalibration {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t validMask;                          // Bit per ColorClass that was sampled
+  uint16_t period[COLOR_CLASS_COUNT][3];      // Mean R/G/B periods (us)
+  uint16_t clear[COLOR_CLASS_COUNT];          // Mean clear-filter period (us)
+  uint16_t crc;
+};
+
+// Feature vector, all per-mil: chromaticity (r+g+b = 1000) and brightness
+// relative to the brightest calibrated surface
+struct ColorFeature {
+  uint16_t r, g, b, brightness;
+};
+
+static ColorCalibration cal;
+static ColorFeature centroid[COLOR_CLASS_COUNT];
+static uint32_t referenceHz = 0;    // R+G+B frequency of the brightest surface
+static bool calibrated = false;
+static uint16_t clearBlackMin = 0;  // Clear period at/above which the surface is BLACK (0 = off)
+static uint16_t clearWhiteMax = 0;  // Clear period at/below which the surface is WHITE (0 = off)
+static uint8_t lastConfidence = 0;
+static uint8_t filterReads = 0;     // Filter reads since the last classification started
+static unsigned long sampleStartMs = 0;  // First / last filter read of that classification
+static unsigned long sampleEndMs = 0;
+static uint8_t scalePercent = COLOR_SCALE_REFERENCE;
+static bool autoScale = COLOR_AUTO_SCALE;
+static bool clearSelected = false;       // Clear filter (no color filter) is selected
+static unsigned long darkestRaw = 0;     // Longest raw R/G/B period of the classification (0 = none)
+static bool darkestTimedOut = false;     // ... or one of them timed out
+
+// Surfaces in the order the calibration command prompts for them
+static const ColorClass CAL_ORDER[] = { COLOR_WHITE, COLOR_BLACK, COLOR_RED, COLOR_GREEN, COLOR_BLUE };
+#define CAL_STEPS (sizeof(CAL_ORDER) / sizeof(CAL_ORDER[0]))
+static int8_t calStep = -1;         // Index into CAL_ORDER, -1 = not calibrating
+
+static const char* const COLOR_NAMES[COLOR_CLASS_COUNT] = {
+  "UNKNOWN", "BLACK", "RED", "GREEN", "BLUE", "WHITE"
+};
 
 // Filter select functions
-void setFilterRed()   { digitalWrite(PIN_S2, LOW);  digitalWrite(PIN_S3, LOW);  }
-void setFilterGreen() { digitalWrite(PIN_S2, HIGH); digitalWrite(PIN_S3, HIGH); }
-void setFilterBlue()  { digitalWrite(PIN_S2, LOW);  digitalWrite(PIN_S3, HIGH); }
+void setFilterRed()   { digitalWrite(PIN_S2, LOW);  digitalWrite(PIN_S3, LOW);  clearSelected = false; }
+void setFilterGreen() { digitalWrite(PIN_S2, HIGH); digitalWrite(PIN_S3, HIGH); clearSelected = false; }
+void setFilterBlue()  { digitalWrite(PIN_S2, LOW);  digitalWrite(PIN_S3, HIGH); clearSelected = false; }
+void setFilterClear() { digitalWrite(PIN_S2, HIGH); digitalWrite(PIN_S3, LOW);  clearSelected = true;  }
+
+// ============ SETUP AND FREQUENCY SCALING ============
+
+/**
+ * Configure sensor pins and start at the reference scaling
+ * Call this from setup() in main .ino file
+ */
+void colorSensorSetup() {
+  pinMode(PIN_S0, OUTPUT);
+  pinMode(PIN_S1, OUTPUT);
+  pinMode(PIN_S2, OUTPUT);
+  pinMode(PIN_S3, OUTPUT);
+  pinMode(PIN_OUT, INPUT);
+  colorSetScale(COLOR_SCALE_REFERENCE);
+}
+
+/**
+ * Set output frequency scaling
+ * S0 S1: L H = 2%, H L = 20%, H H = 100%
+ */
+void colorSetScale(uint8_t percent) {
+  if (percent >= 100) {
+    scalePercent = 100;
+    digitalWrite(PIN_S0, HIGH);
+    digitalWrite(PIN_S1, HIGH);
+  } else if (percent >= 20) {
+    scalePercent = 20;
+    digitalWrite(PIN_S0, HIGH);
+    digitalWrite(PIN_S1, LOW);
+  } else {
+    scalePercent = 2;
+    digitalWrite(PIN_S0, LOW);
+    digitalWrite(PIN_S1, HIGH);
+  }
+}
+
+uint8_t colorScale() {
+  return scalePercent;
+}
+
+void colorSetAutoScale(bool enabled) {
+  autoScale = enabled;
+  if (!enabled) {
+    colorSetScale(COLOR_SCALE_REFERENCE);
+  }
+}
+
+/**
+ * Step the scaling so the next raw period lands in the measurable window:
+ * long periods (dark) are slow to measure, short ones (bright) lose
+ * resolution. The windows overlap after a step, so it does not oscillate.
+ * Fed once per classification with its darkest R/G/B period (see
+ * scaleUpdate()); clear periods are several times shorter and would pull
+ * the scaling down for the next color read.
+ */
+static void adaptScale(unsigned long rawPeriod) {
+  uint8_t next = scalePercent;
+  if (rawPeriod == 0 || rawPeriod > COLOR_SCALE_UP_US) {
+    next = scalePercent == 2 ? 20 : 100;
+  } else if (rawPeriod < COLOR_SCALE_DOWN_US) {
+    next = scalePercent == 100 ? 20 : 2;
+  }
+  if (next != scalePercent) {
+    colorSetScale(next);
+    LOG("[COLOR] Frequency scaling %u%%", scalePercent);
+  }
+}
 
-// Read pulse period for current filter setting
+// Read pulse period for current filter setting, normalized to the reference scaling
 unsigned long readPulseUS() {
+  if (filterReads++ == 0) {
+    sampleStartMs = millis();
+  }
   delay(5);  // Let filter settle
-  unsigned long period = pulseIn(PIN_OUT, LOW, PULSE_TIMEOUT);
+  unsigned long raw = pulseIn(PIN_OUT, LOW, PULSE_TIMEOUT);
+  sampleEndMs = millis();
+  unsigned long period = raw * scalePercent / COLOR_SCALE_REFERENCE;
+  if (!clearSelected) {
+    if (raw == 0) {
+      darkestTimedOut = true;
+    } else {
+      darkestRaw = max(darkestRaw, raw);
+    }
+  }
   return period;
 }
 
-// Read color periods, print to serial, and return dominant color as string
-char* readDominantColor() {
-  // Read red
+// Start a classification: reset the read count and the darkest period
+static void classifyBegin() {
+  filterReads = 0;
+  darkestRaw = 0;
+  darkestTimedOut = false;
+}
+
+// End a classification: adapt the scaling to its darkest R/G/B read, if any
+static void scaleUpdate() {
+  if (autoScale && (darkestRaw != 0 || darkestTimedOut)) {
+    adaptScale(darkestTimedOut ? 0 : darkestRaw);
+  }
+}
+
+// Read all three color filters
+static void readPeriods(unsigned long* r, unsigned long* g, unsigned long* b) {
   setFilterRed();
-  unsigned long periodRed = readPulseUS();
-  
-  // Read green
+  *r = readPulseUS();
   setFilterGreen();
-  unsigned long periodGreen = readPulseUS();
-  
-  // Read blue
+  *g = readPulseUS();
   setFilterBlue();
-  unsigned long periodBlue = readPulseUS();
-  
-  // Print period values
-  Serial.print("Periods (us): R=");
-  Serial.print(periodRed);
-  Serial.print(" G=");
-  Serial.print(periodGreen);
-  Serial.print(" B=");
-  Serial.print(periodBlue);
-  Serial.print(" | Dominant: ");
-  
+  *b = readPulseUS();
+}
+
+// Read the unfiltered (clear) photodiodes - brightness only, one read
+static unsigned long readClear() {
+  setFilterClear();
+  return readPulseUS();
+}
+
+// Store the last reading in the flight recorder's live frame
+static void recordReading(unsigned long r, unsigned long g, unsigned long b, ColorClass color) {
+  flightLive.periodRed = min(r, 65535UL);
+  flightLive.periodGreen = min(g, 65535UL);
+  flightLive.periodBlue = min(b, 65535UL);
+  flightLive.color = color;
+}
+
+// ============ FEATURE MATH (integer only) ============
+
+// Period (us) to frequency (Hz); a timed-out read counts as no light
+static uint32_t toHz(unsigned long periodUs) {
+  return periodUs ? 1000000UL / periodUs : 0;
+}
+
+static ColorFeature toFeature(unsigned long pr, unsigned long pg, unsigned long pb) {
+  ColorFeature f = { 0, 0, 0, 0 };
+  uint32_t hr = toHz(pr), hg = toHz(pg), hb = toHz(pb);
+  uint32_t sum = hr + hg + hb;
+  if (sum == 0) {
+    return f;
+  }
+  f.r = (uint16_t)(hr * 1000UL / sum);
+  f.g = (uint16_t)(hg * 1000UL / sum);
+  f.b = (uint16_t)(1000 - f.r - f.g);
+  f.brightness = referenceHz ? (uint16_t)min(sum * 1000UL / referenceHz, 1000UL) : 0;
+  return f;
+}
+
+static uint32_t distanceSq(const ColorFeature& a, const ColorFeature& c) {
+  int32_t dr = (int32_t)a.r - c.r;
+  int32_t dg = (int32_t)a.g - c.g;
+  int32_t db = (int32_t)a.b - c.b;
+  int32_t dl = (int32_t)a.brightness - c.brightness;
+  return (uint32_t)(dr * dr + dg * dg + db * db + dl * dl);
+}
+
+static uint16_t isqrt(uint32_t x) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+// Rebuild centroids from the stored periods
+static void deriveCentroids() {
+  referenceHz = 0;
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if (cal.validMask & (1 << c)) {
+      uint32_t hz = toHz(cal.period[c][0]) + toHz(cal.period[c][1]) + toHz(cal.period[c][2]);
+      referenceHz = max(referenceHz, hz);
+    }
+  }
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    centroid[c] = toFeature(cal.period[c][0], cal.period[c][1], cal.period[c][2]);
+  }
+
+  // Clear-channel cuts: halfway between BLACK / WHITE and the nearest hue
+  // surface. A cut stays off when the surfaces overlap in brightness.
+  uint16_t darkestHue = 0;
+  uint16_t brightestHue = 0xFFFF;
+  for (uint8_t c = COLOR_RED; c <= COLOR_BLUE; c++) {
+    if (cal.validMask & (1 << c)) {
+      darkestHue = max(darkestHue, cal.clear[c]);
+      brightestHue = min(brightestHue, cal.clear[c]);
+    }
+  }
+  clearBlackMin = 0;
+  clearWhiteMax = 0;
+  if (darkestHue == 0) {
+    return;  // No hue surface calibrated
+  }
+  if ((cal.validMask & (1 << COLOR_BLACK)) && cal.clear[COLOR_BLACK] > darkestHue) {
+    clearBlackMin = (cal.clear[COLOR_BLACK] + darkestHue) / 2;
+  }
+  if ((cal.validMask & (1 << COLOR_WHITE)) && cal.clear[COLOR_WHITE] > 0 &&
+      cal.clear[COLOR_WHITE] < brightestHue) {
+    clearWhiteMax = (cal.clear[COLOR_WHITE] + brightestHue) / 2;
+  }
+}
+
+// ============ CLASSIFIERS ============
+
+// Half-octave bin of a period: 4-1023 us -> 0-15 (timeouts and longer -> 15)
+static uint8_t lutBin(unsigned long p) {
+  if (p == 0 || p >= 1024) return COLOR_LUT_BINS - 1;
+  if (p < 4) return 0;
+  uint8_t octave = 8 * sizeof(unsigned long) - 1 - __builtin_clzl(p);
+  return (uint8_t)((octave - 2) * 2 + ((p >> (octave - 1)) & 1));
+}
+
+/**
+ * Table classifier: the decision regions were precomputed on the host
+ */
+static ColorClass classifyLut(unsigned long pr, unsigned long pg, unsigned long pb) {
+  uint16_t index = ((uint16_t)lutBin(pr) << 8) | (lutBin(pg) << 4) | lutBin(pb);
+  uint8_t cells = LUT_READ(&COLOR_LUT[index >> 1]);
+  return (ColorClass)((index & 1) ? cells >> 4 : cells & 0x0F);
+}
+
+/**
+ * Clear-channel fast path: BLACK or WHITE from brightness alone
+ * Returns UNKNOWN when the reading falls between the cuts and hue is needed.
+ * Confidence scales with how far past the cut the reading is.
+ */
+static ColorClass classifyClear(unsigned long pc, uint8_t* confidence) {
+  if (pc == 0) {
+    return COLOR_UNKNOWN;  // Timed out - let the full read decide
+  }
+  if (clearBlackMin && pc >= clearBlackMin) {
+    unsigned long span = max((unsigned long)cal.clear[COLOR_BLACK] - clearBlackMin, 1UL);
+    *confidence = (uint8_t)min(100UL * (pc - clearBlackMin) / span, 100UL);
+    return COLOR_BLACK;
+  }
+  if (clearWhiteMax && pc <= clearWhiteMax) {
+    unsigned long span = max((unsigned long)clearWhiteMax - cal.clear[COLOR_WHITE], 1UL);
+    *confidence = (uint8_t)min(100UL * (clearWhiteMax - pc) / span, 100UL);
+    return COLOR_WHITE;
+  }
+  return COLOR_UNKNOWN;
+}
+
+/**
+ * Original rule: BLACK if every period is long, else the shortest period wins
+ * Used until the robot has been calibrated
+ */
+static ColorClass classifyThreshold(unsigned long pr, unsigned long pg, unsigned long pb) {
   // Check if black (all values above threshold)
-  if (periodRed > BLACK_THRESHOLD && periodGreen > BLACK_THRESHOLD && periodBlue > BLACK_THRESHOLD) {
-    Serial.println("BLACK");
-    return "BLACK";
+  if (pr > BLACK_THRESHOLD && pg > BLACK_THRESHOLD && pb > BLACK_THRESHOLD) {
+    return COLOR_BLACK;
   }
-  
   // Find dominant color (smallest period = strongest color)
-  if (periodRed > 0 && periodGreen > 0 && periodBlue > 0) {
-    unsigned long minPeriod = min(periodRed, min(periodGreen, periodBlue));
-    
-    if (minPeriod == periodRed) {
-      Serial.println("RED");
-      return "RED";
-    } else if (minPeriod == periodGreen) {
-      Serial.println("GREEN");
-      return "GREEN";
-    } else if (minPeriod == periodBlue) {
-      Serial.println("BLUE");
-      return "BLUE";
-    }
-  }
-  
-  Serial.println("UNKNOWN");
-  return "UNKNOWN";
-}
\ No newline at end of file
+  if (pr > 0 && pg > 0 && pb > 0) {
+    unsigned long minPeriod = min(pr, min(pg, pb));
+    if (minPeriod == pr) return COLOR_RED;
+    if (minPeriod == pg) return COLOR_GREEN;
+    return COLOR_BLUE;
+  }
+  return COLOR_UNKNOWN;
+}
+
+/**
+ * Nearest calibrated centroid in (chromaticity, brightness) space
+ * Confidence compares the nearest and second-nearest distances: 100 when
+ * the reading sits on a centroid, 0 when it is halfway between two.
+ */
+static ColorClass classifyNearest(unsigned long pr, unsigned long pg, unsigned long pb, uint8_t* confidence) {
+  ColorFeature f = toFeature(pr, pg, pb);
+  ColorClass best = COLOR_UNKNOWN;
+  uint32_t bestSq = 0xFFFFFFFFUL;
+  uint32_t secondSq = 0xFFFFFFFFUL;
+
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if (!(cal.validMask & (1 << c))) {
+      continue;
+    }
+    uint32_t d = distanceSq(f, centroid[c]);
+    if (d < bestSq) {
+      secondSq = bestSq;
+      bestSq = d;
+      best = (ColorClass)c;
+    } else if (d < secondSq) {
+      secondSq = d;
+    }
+  }
+
+  uint16_t nearest = isqrt(bestSq);
+  if (best == COLOR_UNKNOWN || nearest > COLOR_MAX_DISTANCE) {
+    *confidence = 0;
+    return COLOR_UNKNOWN;
+  }
+  if (secondSq == 0xFFFFFFFFUL) {
+    *confidence = 100;
+    return best;
+  }
+  uint16_t second = isqrt(secondSq);
+  *confidence = second ? (uint8_t)(100UL * (second - nearest) / second) : 0;
+  return best;
+}
+
+// ============ READING ============
+
+/**
+ * Read the sensor and classify the surface
+ * When calibrated, one clear-filter read settles BLACK and WHITE; the three
+ * color filters are only read when hue is actually needed.
+ */
+ColorClass readColorClass() {
+  classifyBegin();
+  if (clearBlackMin || clearWhiteMax) {
+    unsigned long periodClear = readClear();
+    ColorClass quick = classifyClear(periodClear, &lastConfidence);
+    if (quick != COLOR_UNKNOWN) {
+      LOG("Clear (us): C=%lu | Dominant: %s (%u%%)", periodClear, COLOR_NAMES[quick], lastConfidence);
+      flightLive.color = quick;  // R/G/B periods were not read
+      return quick;
+    }
+  }
+
+  unsigned long periodRed, periodGreen, periodBlue;
+  readPeriods(&periodRed, &periodGreen, &periodBlue);
+
+  ColorClass color;
+  if (COLOR_USE_LUT) {
+    color = classifyLut(periodRed, periodGreen, periodBlue);
+    lastConfidence = color == COLOR_UNKNOWN ? 0 : 100;
+  } else if (calibrated) {
+    color = classifyNearest(periodRed, periodGreen, periodBlue, &lastConfidence);
+  } else {
+    color = classifyThreshold(periodRed, periodGreen, periodBlue);
+    lastConfidence = 0;
+  }
+
+  LOG("Periods (us): R=%lu G=%lu B=%lu | Dominant: %s (%u%%)",
+      periodRed, periodGreen, periodBlue, COLOR_NAMES[color], lastConfidence);
+  recordReading(periodRed, periodGreen, periodBlue, color);
+  scaleUpdate();
+  return color;
+}
+
+// Read color periods, log them, and return dominant color as string
+const char* readDominantColor() {
+  return COLOR_NAMES[readColorClass()];
+}
+
+/**
+ * Black / not-black from a single clear-filter read
+ * Falls back to a full classification when uncalibrated.
+ */
+bool colorIsBlack() {
+  classifyBegin();
+  if (!clearBlackMin) {
+    return readColorClass() == COLOR_BLACK;
+  }
+
+  unsigned long periodClear = readClear();
+  bool black = classifyClear(periodClear, &lastConfidence) == COLOR_BLACK;
+  LOG("Clear (us): C=%lu | BLACK: %s", periodClear, black ? "yes" : "no");
+  if (black) {
+    flightLive.color = COLOR_BLACK;
+  }
+  return black;
+}
+
+// ============ CANDIDATE-SET CLASSIFIER ============
+// Filters are indexed R, G, B, C to match readFilter().
+
+static void readFilter(uint8_t ch, unsigned long* period) {
+  switch (ch) {
+    case 0: setFilterRed();   break;
+    case 1: setFilterGreen(); break;
+    case 2: setFilterBlue();  break;
+    default: setFilterClear(); break;
+  }
+  *period = readPulseUS();
+}
+
+static uint16_t calPeriod(uint8_t c, uint8_t ch) {
+  return ch < 3 ? cal.period[c][ch] : cal.clear[c];
+}
+
+// Difference of a and b, per-mil of b
+static uint16_t relativeError(unsigned long a, uint16_t b) {
+  if (b == 0) {
+    return 1000;
+  }
+  unsigned long diff = a > b ? a - b : b - a;
+  return (uint16_t)min(diff * 1000UL / b, 1000UL);
+}
+
+// Unread filter that tells apart the most candidate pairs (ties: widest total gap)
+static uint8_t bestFilter(ColorSet set, uint8_t readMask) {
+  uint8_t best = 0xFF;
+  uint8_t bestPairs = 0;
+  uint32_t bestGap = 0;
+
+  for (uint8_t ch = 0; ch < 4; ch++) {
+    if (readMask & (1 << ch)) {
+      continue;
+    }
+    uint8_t pairs = 0;
+    uint32_t gap = 0;
+    for (uint8_t a = 0; a < COLOR_CLASS_COUNT; a++) {
+      if (!(set & COLOR_SET(a))) continue;
+      for (uint8_t b = a + 1; b < COLOR_CLASS_COUNT; b++) {
+        if (!(set & COLOR_SET(b))) continue;
+        uint16_t e = relativeError(calPeriod(a, ch), calPeriod(b, ch));
+        gap += e;
+        if (e > 2 * COLOR_AMONG_MARGIN) {
+          pairs++;
+        }
+      }
+    }
+    if (best == 0xFF || pairs > bestPairs || (pairs == bestPairs && gap > bestGap)) {
+      best = ch;
+      bestPairs = pairs;
+      bestGap = gap;
+    }
+  }
+  return best;
+}
+
+/**
+ * Classify the surface as one of a few expected colors
+ * Reads one filter at a time - always the one that best separates the
+ * candidates still in the running - and stops as soon as one is left
+ * that matches closely.
+ * Returns UNKNOWN when the surface matches none of them; colorLastFilterReads()
+ * tells how many reads it took.
+ * Falls back to readColorClass() until every candidate is calibrated.
+ */
+ColorClass classifyAmong(ColorSet candidates) {
+  candidates &= ~COLOR_SET(COLOR_UNKNOWN);
+  if (!calibrated || (candidates & cal.validMask) != candidates || candidates == 0) {
+    ColorClass color = readColorClass();
+    return (candidates & COLOR_SET(color)) ? color : COLOR_UNKNOWN;
+  }
+
+  classifyBegin();
+  ColorSet alive = candidates;
+  uint8_t readMask = 0;
+  uint16_t worstError[COLOR_CLASS_COUNT] = { 0 };  // Worst per-filter error so far
+  unsigned long period[4] = { 0, 0, 0, 0 };
+
+  while (readMask != 0x0F) {
+    uint8_t ch = bestFilter(alive, readMask);
+    readFilter(ch, &period[ch]);
+    readMask |= 1 << ch;
+    unsigned long p = period[ch] ? period[ch] : PULSE_TIMEOUT;  // Timed out: darker than anything
+
+    uint16_t bestError = 0xFFFF;
+    uint16_t error[COLOR_CLASS_COUNT];
+    for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+      if (alive & COLOR_SET(c)) {
+        error[c] = relativeError(p, calPeriod(c, ch));
+        bestError = min(bestError, error[c]);
+      }
+    }
+    for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+      if (alive & COLOR_SET(c)) {
+        worstError[c] = max(worstError[c], error[c]);
+        if (error[c] > bestError + COLOR_AMONG_MARGIN) {
+          alive &= ~COLOR_SET(c);
+        }
+      }
+    }
+
+    // Unambiguous: one candidate left and it matches this filter closely.
+    // A poor lone match keeps reading, so an off-set surface ends as UNKNOWN.
+    if (!(alive & (alive - 1)) && bestError <= COLOR_AMONG_MATCH) {
+      break;
+    }
+  }
+
+  // One left, or every filter read: the smallest worst-case error wins
+  ColorClass color = COLOR_UNKNOWN;
+  uint16_t error = 0xFFFF;
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if ((alive & COLOR_SET(c)) && worstError[c] < error) {
+      error = worstError[c];
+      color = (ColorClass)c;
+    }
+  }
+  if (error > COLOR_AMONG_MAX_ERROR) {
+    color = COLOR_UNKNOWN;
+    lastConfidence = 0;
+  } else {
+    lastConfidence = (uint8_t)(100UL * (COLOR_AMONG_MAX_ERROR - error) / COLOR_AMONG_MAX_ERROR);
+  }
+
+  LOG("Among 0x%02x: %s (%u%%, %u reads)", candidates, COLOR_NAMES[color], lastConfidence, filterReads);
+  if (readMask & 0x01) flightLive.periodRed = min(period[0], 65535UL);
+  if (readMask & 0x02) flightLive.periodGreen = min(period[1], 65535UL);
+  if (readMask & 0x04) flightLive.periodBlue = min(period[2], 65535UL);
+  flightLive.color = color;
+  scaleUpdate();
+  return color;
+}
+
+const char* colorName(ColorClass color) {
+  return color < COLOR_CLASS_COUNT ? COLOR_NAMES[color] : COLOR_NAMES[COLOR_UNKNOWN];
+}
+
+ColorClass colorFromName(const char* name) {
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if (strcmp(name, COLOR_NAMES[c]) == 0) {
+      return (ColorClass)c;
+    }
+  }
+  return COLOR_UNKNOWN;
+}
+
+uint8_t colorLastConfidence() {
+  return lastConfidence;
+}
+
+uint8_t colorLastFilterReads() {
+  return filterReads;
+}
+
+unsigned long colorLastSampleMs() {
+  return sampleStartMs + (sampleEndMs - sampleStartMs) / 2;
+}
+
+// ============ CALIBRATION ============
+
+static uint16_t calibrationCrc(const ColorCalibration& c) {
+  const uint8_t* bytes = (const uint8_t*)&c;
+  uint16_t crc = CRC16_INIT;
+  for (uint8_t i = 0; i < offsetof(ColorCalibration, crc); i++) {
+    crc = crc16Update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+/**
+ * Load the calibration record; false (threshold classifier) if missing or corrupt
+ */
+bool colorCalibrationLoad() {
+  static_assert(sizeof(ColorCalibration) <= EEPROM_COLOR_CAL_SIZE, "ColorCalibration outgrew its EEPROM slot");
+
+  EEPROM.get(EEPROM_COLOR_CAL_ADDR, cal);
+  calibrated = cal.magic == EEPROM_COLOR_CAL_MAGIC &&
+               cal.version == COLOR_CAL_VERSION &&
+               cal.crc == calibrationCrc(cal) &&
+               cal.validMask != 0;
+  if (calibrated) {
+    deriveCentroids();
+  } else {
+    memset(&cal, 0, sizeof(cal));
+  }
+  return calibrated;
+}
+
+bool colorCalibrated() {
+  return calibrated;
+}
+
+static void calibrationPrompt() {
+  Serial.print(F("[CAL] Place sensor over "));
+  Serial.print(COLOR_NAMES[CAL_ORDER[calStep]]);
+  Serial.print(F(" and send '"));
+  Serial.print(COLOR_CAL_CMD);
+  Serial.println(F("'"));
+}
+
+// Average COLOR_CAL_SAMPLES readings of the current surface; timeouts are skipped
+static void sampleSurface(ColorClass color) {
+  unsigned long sum[4] = { 0, 0, 0, 0 };
+  uint8_t good[4] = { 0, 0, 0, 0 };
+
+  // Sample at the reference scaling - the stored periods are in its units
+  bool wasAuto = autoScale;
+  autoScale = false;
+  colorSetScale(COLOR_SCALE_REFERENCE);
+
+  for (uint8_t i = 0; i < COLOR_CAL_SAMPLES; i++) {
+    unsigned long p[4];
+    readPeriods(&p[0], &p[1], &p[2]);
+    p[3] = readClear();
+    for (uint8_t ch = 0; ch < 4; ch++) {
+      if (p[ch] > 0) {
+        sum[ch] += p[ch];
+        good[ch]++;
+      }
+    }
+  }
+
+  for (uint8_t ch = 0; ch < 3; ch++) {
+    cal.period[color][ch] = good[ch] ? (uint16_t)min(sum[ch] / good[ch], 65535UL) : 0;
+  }
+  cal.clear[color] = good[3] ? (uint16_t)min(sum[3] / good[3], 65535UL) : 0;
+  autoScale = wasAuto;
+  cal.validMask |= 1 << color;
+
+  Serial.print(F("[CAL] "));
+  Serial.print(COLOR_NAMES[color]);
+  Serial.print(F(": R="));
+  Serial.print(cal.period[color][0]);
+  Serial.print(F(" G="));
+  Serial.print(cal.period[color][1]);
+  Serial.print(F(" B="));
+  Serial.print(cal.period[color][2]);
+  Serial.print(F(" C="));
+  Serial.println(cal.clear[color]);
+}
+
+/**
+ * Step the calibration: the first call prompts for the first surface, each
+ * following call samples the prompted surface; after the last one the
+ * record is written to EEPROM and used immediately.
+ * Sampling blocks for a few hundred ms - only calibrate with the robot parked.
+ */
+void colorCalibrationCommand() {
+  if (calStep < 0) {
+    memset(&cal, 0, sizeof(cal));
+    calibrated = false;
+    clearBlackMin = 0;  // The fast path must not use the old calibration
+    clearWhiteMax = 0;
+    calStep = 0;
+    Serial.println(F("[CAL] Color calibration started"));
+    calibrationPrompt();
+    return;
+  }
+
+  sampleSurface(CAL_ORDER[calStep]);
+  calStep++;
+  if (calStep < (int8_t)CAL_STEPS) {
+    calibrationPrompt();
+    return;
+  }
+
+  cal.magic = EEPROM_COLOR_CAL_MAGIC;
+  cal.version = COLOR_CAL_VERSION;
+  cal.crc = calibrationCrc(cal);
+  EEPROM.put(EEPROM_COLOR_CAL_ADDR, cal);
+  deriveCentroids();
+  calibrated = true;
+  calStep = -1;
+  Serial.println(F("[CAL] Saved to EEPROM - nearest-centroid classifier active"));
+  Serial.print(F("[CAL] Clear fast path: BLACK >= "));
+  Serial.print(clearBlackMin);
+  Serial.print(F(" us, WHITE <= "));
+  Serial.print(clearWhiteMax);
+  Serial.println(F(" us (0 = off)"));
+}
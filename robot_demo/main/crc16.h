@@ -0,0 +1,18 @@
+/* CRC-16/CCITT (poly 0x1021, init 0xFFFF) shared by the recorder and telemetry. */
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+
+#define CRC16_INIT 0xFFFF
+
+// Fold one byte into the running CRC
+inline uint16_t crc16Update(uint16_t crc, uint8_t b) {
+  crc ^= (uint16_t)b << 8;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+#endif  // CRC16_H
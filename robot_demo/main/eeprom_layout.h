@@ -0,0 +1,26 @@
+/* EEPROM map for calibration that must survive reflashing. */
+#ifndef EEPROM_LAYOUT_H
+#define EEPROM_LAYOUT_H
+
+// Each record starts with a 16-bit magic and a version byte and ends with a
+// CRC-16 over everything before it. A record that fails any of the three
+// checks is ignored and the module falls back to its #define defaults.
+// Records get a fixed slot so growing one never moves the others.
+
+// ============ RECORD SLOTS ============
+#define EEPROM_COLOR_CAL_ADDR   0     // ColorCalibration (color_sensor_func)
+#define EEPROM_COLOR_CAL_SIZE   64
+#define EEPROM_TURN_CAL_ADDR    64    // TurnCalibration (motor_func)
+#define EEPROM_TURN_CAL_SIZE    32
+#define EEPROM_WHEEL_CAL_ADDR   96    // WheelCalibration (motor_func)
+#define EEPROM_WHEEL_CAL_SIZE   48
+#define EEPROM_LAP_ADDR         144   // LapRecord (lap_memory, main sketch)
+#define EEPROM_LAP_SIZE         256
+
+// ============ RECORD MAGICS ============
+#define EEPROM_COLOR_CAL_MAGIC  0xC01A
+#define EEPROM_TURN_CAL_MAGIC   0x7C4A
+#define EEPROM_WHEEL_CAL_MAGIC  0x3EC1
+#define EEPROM_LAP_MAGIC        0x1A9E
+
+#endif  // EEPROM_LAYOUT_H
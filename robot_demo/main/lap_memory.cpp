@@ -0,0 +1,319 @@
+/* Lap memory: segment recorder on the learning lap, speed and arc feed-forward on replay laps. */
+#include "lap_memory.h"
+#include "line_follow_func.h"
+#include "odometry.h"
+#include "log_sink.h"
+#include "eeprom_layout.h"
+#include "crc16.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+// ============ LAP STATE ============
+enum LapMode {
+  LAP_MODE_LEARN,   // Recording the first lap
+  LAP_MODE_REPLAY,  // Driving the learned lap
+  LAP_MODE_OFF      // Reactive following only
+};
+
+static LapRecord lap;
+static LapMode mode = LAP_MODE_LEARN;
+static bool lapStarted = false;           // Learning: start pose taken
+static float lapStartDist = 0;            // odometryDistance() at the lap start
+static unsigned long lapStartMs = 0;
+static OdoPose lapStartPose;
+static float closestToStart = 0;          // Learning: nearest approach once back near the start
+static uint16_t lapsDone = 0;             // Replay laps completed
+static bool replayInBend = false;         // Replay: curvature estimate above LAP_BEND_ON
+
+// Segment being recorded
+static uint8_t segKind = LAP_STRAIGHT;
+static float segStartDist = 0;
+static unsigned long segStartMs = 0;
+static float segStartTheta = 0;
+static uint8_t segMinSpeed = 255;
+
+// ============ RECORD ============
+
+static uint16_t lapCrc(const LapRecord& record) {
+  const uint8_t* bytes = (const uint8_t*)&record;
+  uint16_t crc = CRC16_INIT;
+  for (uint16_t i = 0; i < offsetof(LapRecord, crc); i++) {
+    crc = crc16Update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+static bool lapLoad() {
+  static_assert(sizeof(LapRecord) <= EEPROM_LAP_SIZE, "LapRecord outgrew its EEPROM slot");
+
+  EEPROM.get(EEPROM_LAP_ADDR, lap);
+  return lap.magic == EEPROM_LAP_MAGIC && lap.version == LAP_VERSION &&
+         lap.count > 0 && lap.count <= LAP_MAX_SEGMENTS && lap.crc == lapCrc(lap);
+}
+
+static void lapSave() {
+  lap.magic = EEPROM_LAP_MAGIC;
+  lap.version = LAP_VERSION;
+  lap.crc = lapCrc(lap);
+  EEPROM.put(EEPROM_LAP_ADDR, lap);
+}
+
+// ============ MODE CHANGES ============
+
+static void replayBegin(float dist, unsigned long now) {
+  mode = LAP_MODE_REPLAY;
+  lapStartDist = dist;
+  lapStartMs = now;
+  replayInBend = false;
+}
+
+static void replayAbandon() {
+  lineFollowFeedForward(0, 0);
+  mode = LAP_MODE_OFF;
+}
+
+// ============ LEARNING ============
+
+static void segmentBegin(float dist, unsigned long now) {
+  segStartDist = dist;
+  segStartMs = now;
+  segStartTheta = odometryPose().theta;
+  segMinSpeed = 255;
+}
+
+/**
+ * Append the segment recorded so far and start the next one
+ * @return false when the record is full
+ */
+static bool segmentEnd(float dist, unsigned long now) {
+  if (lap.count >= LAP_MAX_SEGMENTS) {
+    return false;
+  }
+  LapSegment& seg = lap.segments[lap.count++];
+  seg.lengthMm = min(dist - segStartDist, 65535.0f);
+  seg.durationMs = min(now - segStartMs, 65535UL);
+  seg.turnHalfDeg = constrain(lround(degrees(odometryPose().theta - segStartTheta) / 2), -127L, 127L);
+  seg.speed = segMinSpeed;
+  seg.kind = segKind;
+  segmentBegin(dist, now);
+  return true;
+}
+
+static void startLap(float dist, unsigned long now) {
+  lapStarted = true;
+  lapStartDist = dist;
+  lapStartMs = now;
+  lapStartPose = odometryPose();
+  closestToStart = LAP_CLOSE_MM;
+  lap.count = 0;
+  segKind = LAP_STRAIGHT;
+  segmentBegin(dist, now);
+}
+
+/**
+ * Cut the learning lap into straights and bends; save it once odometry
+ * puts the robot back at the start (at its nearest approach within
+ * LAP_CLOSE_MM)
+ */
+static void learnStep(LineFollowState state, float dist, unsigned long now) {
+  if (state == STATE_LF_LOST || state == STATE_LF_STOPPED) {
+    if (lapStarted) {
+      LOG("[LAP] Line lost - learning lap restarts when it is found");
+      lapStarted = false;
+    }
+    return;
+  }
+  if (!lapStarted) {
+    startLap(dist, now);
+    LOG("[LAP] Learning the lap");
+    return;
+  }
+
+  segMinSpeed = min(segMinSpeed, (uint8_t)lineFollowSpeed());
+  float curve = lineFollowCurvature();
+  uint8_t kind = segKind;
+  if (segKind == LAP_STRAIGHT && curve > LAP_BEND_ON) {
+    kind = LAP_BEND;
+  } else if (segKind == LAP_BEND && curve < LAP_BEND_OFF) {
+    kind = LAP_STRAIGHT;
+  }
+  if (kind != segKind && dist - segStartDist >= LAP_MIN_SEGMENT_MM) {
+    if (!segmentEnd(dist, now)) {
+      LOG("[LAP] More than %u segments - lap memory off", LAP_MAX_SEGMENTS);
+      mode = LAP_MODE_OFF;
+      return;
+    }
+    segKind = kind;
+  }
+
+  OdoPose pose = odometryPose();
+  float fromStart = sqrt(sq(pose.x - lapStartPose.x) + sq(pose.y - lapStartPose.y));
+  if (dist - lapStartDist < LAP_MIN_MM || fromStart > LAP_CLOSE_MM) {
+    return;
+  }
+  if (fromStart <= closestToStart) {
+    closestToStart = fromStart;  // Still closing in: the lap ends at the nearest point
+    return;
+  }
+  if (!segmentEnd(dist, now)) {
+    mode = LAP_MODE_OFF;
+    return;
+  }
+  lap.lengthMm = min(dist - lapStartDist, 65535.0f);
+  lap.lapMs = now - lapStartMs;
+  lapSave();
+  LOG("[LAP] Lap learned: %u segments, %u mm, %lu ms - saved, replaying",
+      lap.count, lap.lengthMm, lap.lapMs);
+
+  replayBegin(dist, now);
+  lapsDone = 0;
+}
+
+// ============ REPLAY ============
+
+/**
+ * Distance from `pos` to the nearest learned bend start, around the lap
+ * (positive: the robot is past it)
+ */
+static float bendStartError(float pos) {
+  float best = lap.lengthMm;
+  float segStart = 0;
+  for (uint8_t i = 0; i < lap.count; i++) {
+    if (lap.segments[i].kind == LAP_BEND) {
+      float error = pos - segStart;
+      if (error > lap.lengthMm / 2.0) {
+        error -= lap.lengthMm;
+      } else if (error < -lap.lengthMm / 2.0) {
+        error += lap.lengthMm;
+      }
+      if (fabs(error) < fabs(best)) {
+        best = error;
+      }
+    }
+    segStart += lap.segments[i].lengthMm;
+  }
+  return best;
+}
+
+/**
+ * Feed the learned speed and arc for the current distance into the lap
+ * Bends the line follower finds re-anchor the distance; a bend or a lap
+ * close that does not match the learned lap ends the replay.
+ */
+static void replayStep(LineFollowState state, float dist, unsigned long now) {
+  if (state == STATE_LF_LOST || state == STATE_LF_STOPPED) {
+    LOG("[LAP] Line lost - replay off, following reactively");
+    replayAbandon();
+    return;
+  }
+
+  float pos = dist - lapStartDist;
+  float curve = lineFollowCurvature();
+  if (!replayInBend && curve > LAP_BEND_ON) {
+    replayInBend = true;
+    float error = bendStartError(pos);
+    if (fabs(error) > LAP_MISMATCH_MM) {
+      LOG("[LAP] Bend %d mm from any learned one - replay off, following reactively", (int)error);
+      replayAbandon();
+      return;
+    }
+    lapStartDist += error;  // Snap to the learned bend start
+    pos -= error;
+  } else if (replayInBend && curve < LAP_BEND_OFF) {
+    replayInBend = false;
+  }
+
+  if (pos >= lap.lengthMm) {
+    OdoPose pose = odometryPose();
+    float fromStart = sqrt(sq(pose.x - lapStartPose.x) + sq(pose.y - lapStartPose.y));
+    if (fromStart > LAP_MISMATCH_MM) {
+      LOG("[LAP] Lap closed %d mm from its start - replay off, following reactively", (int)fromStart);
+      replayAbandon();
+      return;
+    }
+    lapsDone++;
+    LOG("[LAP] Lap %u: %lu ms (learning lap %lu ms)", lapsDone, now - lapStartMs, lap.lapMs);
+    lapStartDist += lap.lengthMm;
+    lapStartMs = now;
+    lapStartPose = pose;  // Compare the next lap with this one: odometry drifts slowly
+    pos -= lap.lengthMm;
+  }
+  if (pos < 0) {
+    pos += lap.lengthMm;  // Snapped back to a bend at the end of the lap
+  }
+
+  float segStart = 0;
+  uint8_t i = 0;
+  while (i + 1 < lap.count && pos >= segStart + lap.segments[i].lengthMm) {
+    segStart += lap.segments[i].lengthMm;
+    i++;
+  }
+  const LapSegment& seg = lap.segments[i];
+  const LapSegment& next = lap.segments[(i + 1) % lap.count];
+
+  if (seg.kind == LAP_BEND) {
+    float arc = seg.lengthMm > 0 ? radians(seg.turnHalfDeg * 2.0) / seg.lengthMm : 0;
+    lineFollowFeedForward(min(seg.speed + LAP_BEND_BONUS, 255), arc);
+  } else if (next.kind == LAP_BEND && segStart + seg.lengthMm - pos < LAP_BRAKE_AHEAD_MM) {
+    // Pre-emptive slow-down: reach the bend at its speed
+    lineFollowFeedForward(min(next.speed + LAP_BEND_BONUS, LAP_STRAIGHT_SPEED), 0);
+  } else {
+    lineFollowFeedForward(LAP_STRAIGHT_SPEED, 0);
+  }
+}
+
+// ============ LAP MEMORY ============
+
+void lapSetup() {
+  if (lapLoad()) {
+    replayBegin(odometryDistance(), millis());
+    lapStartPose = odometryPose();
+    lapPrint();
+    Serial.println(F("[LAP] Learned lap loaded - start where it was learned (send 'p' to relearn)"));
+  } else {
+    mode = LAP_MODE_LEARN;
+    Serial.println(F("[LAP] No learned lap - the first lap will be learned"));
+  }
+  lapStarted = false;
+}
+
+void lapUpdate() {
+  float dist = odometryDistance();
+  unsigned long now = millis();
+  if (mode == LAP_MODE_LEARN) {
+    learnStep(lineFollowGetState(), dist, now);
+  } else if (mode == LAP_MODE_REPLAY) {
+    replayStep(lineFollowGetState(), dist, now);
+  }
+}
+
+void lapCommand() {
+  lineFollowFeedForward(0, 0);
+  mode = LAP_MODE_LEARN;
+  lapStarted = false;
+  Serial.println(F("[LAP] Learning a new lap from here"));
+}
+
+/**
+ * Print the segments of the lap in use
+ */
+void lapPrint() {
+  Serial.print(F("[LAP] "));
+  Serial.print(lap.count);
+  Serial.print(F(" segments, "));
+  Serial.print(lap.lengthMm);
+  Serial.print(F(" mm, "));
+  Serial.print(lap.lapMs);
+  Serial.println(F(" ms"));
+  for (uint8_t i = 0; i < lap.count; i++) {
+    const LapSegment& seg = lap.segments[i];
+    Serial.print(seg.kind == LAP_BEND ? "  bend     " : "  straight ");
+    Serial.print(seg.lengthMm);
+    Serial.print(F(" mm  "));
+    Serial.print(seg.durationMs);
+    Serial.print(F(" ms  "));
+    Serial.print(seg.turnHalfDeg * 2);
+    Serial.print(F(" deg  speed "));
+    Serial.println(seg.speed);
+  }
+}
@@ -0,0 +1,67 @@
+/* Lap memory: learn a closed line course as segments on the first lap, replay it faster after. */
+#ifndef LAP_MEMORY_H
+#define LAP_MEMORY_H
+
+#include "Arduino.h"
+
+// ============ LAP MEMORY CONFIGURATION ============
+// The first lap is followed reactively and cut into straights and bends
+// by the line follower's curvature estimate; odometry gives each segment's
+// length and heading change, and closes the lap when the robot is back at
+// its start. Later laps feed the learned speed and arc forward by distance
+// driven, slowing before each bend; the IR sensors only correct. Each bend
+// the curvature estimate picks up re-anchors the distance to the nearest
+// learned bend start, and each lap must close near the start pose; a
+// mismatch over LAP_MISMATCH_MM drops back to reactive following.
+#define LAP_CMD              'p'    // Serial command: forget the lap, learn again from here
+#define LAP_VERSION          2
+#define LAP_MAX_SEGMENTS     20     // RAM: 7 bytes each
+#define LAP_BEND_ON          0.35   // Curvature estimate that starts a bend
+#define LAP_BEND_OFF         0.15   // ... and ends it
+#define LAP_MIN_SEGMENT_MM   40     // Shorter segments run on into the next
+#define LAP_MIN_MM           1500   // Shortest possible lap
+#define LAP_CLOSE_MM         200    // Back within this of the start = lap closed
+#define LAP_STRAIGHT_SPEED   230    // Replay speed on straights
+#define LAP_BEND_BONUS       15     // Replay bend speed above the learning lap's slowest
+#define LAP_BRAKE_AHEAD_MM   120    // Slow to the bend speed this far before a bend
+#define LAP_MISMATCH_MM      150    // Replay: largest bend or lap-close error still trusted
+
+// ============ LAP RECORD ============
+enum LapSegmentKind {
+  LAP_STRAIGHT,
+  LAP_BEND
+};
+
+struct __attribute__((packed)) LapSegment {
+  uint16_t lengthMm;    // Path length (odometry)
+  uint16_t durationMs;  // Time on the learning lap
+  int8_t turnHalfDeg;   // Heading change / 2, + left
+  uint8_t speed;        // Slowest forward speed on the learning lap
+  uint8_t kind;         // LapSegmentKind
+};
+
+struct __attribute__((packed)) LapRecord {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t count;        // Segments used
+  uint16_t lengthMm;    // Whole lap
+  uint32_t lapMs;       // Learning lap time
+  LapSegment segments[LAP_MAX_SEGMENTS];
+  uint16_t crc;
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Load a learned lap (replay) or prepare to learn one - call after lineFollowSetup()
+void lapSetup();
+
+// Learn or replay - call once per line follow tick, before the FSM step
+void lapUpdate();
+
+// Forget the lap in use and learn a new one starting here
+void lapCommand();
+
+// Print the lap in use
+void lapPrint();
+
+#endif  // LAP_MEMORY_H
@@ -7,9 +7,60 @@
 #include "Arduino.h"
 #include "line_follow_func.h"
 #include "color_sensor_func.h"
+#include "flight_recorder.h"
+#include "state_watchdog.h"
+#include "odometry.h"
+#include "log_sink.h"
 
 // ============ GLOBAL STATE VARIABLES ============
 LineFollowState currentLFState = STATE_LF_FORWARD;
+static uint8_t recoverSteps = 0;  // Consecutive watchdog recoveries
+
+// ============ LINE MEMORY ============
+static LineSide lastSide = LINE_SIDE_LEFT;  // Way the follower last steered
+static unsigned long lastSeenMs = 0;        // millis() the line was last under a sensor
+static unsigned long searchStartMs = 0;     // millis() the line-lost search began
+
+// ============ SPEED SCHEDULE ============
+static float curvature = 0;                 // 0 straight .. 1 correcting all the time
+static float scheduledSpeed = LF_SPEED_MIN;  // Rate-limited forward speed
+static unsigned long scheduledAt = 0;       // millis() of the last update
+static int feedSpeed = 0;                   // Feed-forward speed (0 = scheduled)
+static float feedCurve = 0;                 // Feed-forward arc curvature (rad/mm, + left)
+
+// ============ ROUTE ============
+// Junction maneuver: drive on to the crossing, then turn (or straight across)
+enum JunctionPhase {
+  JUNCTION_PHASE_CENTER,  // Driving on from the detection
+  JUNCTION_PHASE_TURN     // Turning onto the chosen branch
+};
+
+static const JunctionAction* route = NULL;  // One action per junction
+static uint8_t routeCount = 0;              // 0 = no route: junctions not detected
+static ColorSet junctionMarkers = 0;        // Colors that mark a junction
+static uint8_t junctionCount = 0;           // Junctions reached
+static JunctionAction junctionAction = JUNCTION_STRAIGHT;
+static JunctionPhase junctionPhase = JUNCTION_PHASE_CENTER;
+static unsigned long junctionLeftMs = 0;    // millis() the last junction was cleared
+
+// State names for the watchdog log (order must match LineFollowState)
+static const StateName LF_STATE_NAMES[] PROGMEM = {
+  "LF_FORWARD", "LF_CORRECT_LEFT", "LF_CORRECT_RIGHT", "LF_STOPPED", "LF_LOST", "LF_JUNCTION"
+};
+
+// Budget {ms, ticks} per visit, by LineFollowState (0 = no limit)
+static const StateBudget LF_BUDGETS[] PROGMEM = {
+  { 0, 0 },                                              // FORWARD
+  { LF_CORRECT_BUDGET_MS, LF_CORRECT_BUDGET_TICKS },     // CORRECT_LEFT
+  { LF_CORRECT_BUDGET_MS, LF_CORRECT_BUDGET_TICKS },     // CORRECT_RIGHT
+  { 0, 0 },                                              // STOPPED
+  { 0, 0 },                                              // LOST - bounded by its own phases
+  { 0, 0 },                                              // JUNCTION - timed maneuvers
+};
+
+static StateWatchdog lfWatchdog = {
+  "LF", LF_STATE_NAMES, LF_BUDGETS, STATE_LF_JUNCTION + 1, STATE_LF_FORWARD, 0, 0, { 0 }
+};
 
 // ============ IR SENSOR FUNCTIONS ============
 
@@ -43,8 +94,230 @@ void lineFollowSetup() {
   // Motor pins
   motorSetup();
 
+  lineFollowReset();
+  Serial.println(F("[LF] Line follow system initialized"));
+}
+
+/**
+ * Current line follow state (for recording/instrumentation)
+ */
+LineFollowState lineFollowGetState() {
+  return currentLFState;
+}
+
+/**
+ * Start over from STATE_LF_FORWARD with a fresh correction budget
+ * Call when line following resumes after another FSM drove the wheels.
+ */
+void lineFollowReset() {
   currentLFState = STATE_LF_FORWARD;
-  Serial.println("[LF] Line follow system initialized");
+  recoverSteps = 0;
+  lastSeenMs = millis();
+  curvature = 0;
+  scheduledSpeed = LF_SPEED_MIN;  // Pick up speed from a standstill
+  scheduledAt = lastSeenMs;
+  watchdogRestart(&lfWatchdog);
+}
+
+/**
+ * Enter STATE_LF_LOST and search toward `side`
+ */
+void lineFollowSearch(LineSide side) {
+  lastSide = side;
+  searchStartMs = millis();
+  currentLFState = STATE_LF_LOST;
+  LOG("[LF] Searching for the line to the %s", side == LINE_SIDE_LEFT ? "left" : "right");
+}
+
+void lineFollowFeedForward(int speed, float curvePerMm) {
+  feedSpeed = speed;
+  feedCurve = curvePerMm;
+}
+
+void lineFollowSetRoute(const JunctionAction* actions, uint8_t count, ColorSet markers) {
+  route = actions;
+  routeCount = count;
+  junctionMarkers = markers;
+  junctionCount = 0;
+}
+
+uint8_t lineFollowJunctions() {
+  return junctionCount;
+}
+
+int lineFollowSpeed() {
+  return (int)scheduledSpeed;
+}
+
+float lineFollowCurvature() {
+  return curvature;
+}
+
+void lineFollowPrintWatchdog() {
+  watchdogPrint(&lfWatchdog);
+}
+
+// ============ WATCHDOG RECOVERY ============
+
+/**
+ * A correction ran out of budget: the line is no longer beside the IR
+ * sensor that triggered it. Back up along the approach and re-acquire.
+ */
+static void lineFollowRecover() {
+  if (recoverSteps < LF_RECOVER_MAX_STEPS) {
+    recoverSteps++;
+  }
+  LOG("[LF] Correction stuck - backing up %u ms to re-acquire", LF_RECOVER_REVERSE_MS * recoverSteps);
+  motorMoveBackwardTime(LINE_FOLLOW_SPEED, LF_RECOVER_REVERSE_MS * recoverSteps);
+  currentLFState = STATE_LF_FORWARD;
+}
+
+// ============ SPEED SCHEDULING ============
+
+/**
+ * Update the curvature estimate and the forward speed it allows
+ * @param correcting This tick is spent steering back to the line
+ */
+static void scheduleSpeed(bool correcting) {
+  unsigned long now = millis();
+  float dt = (now - scheduledAt) / 1000.0;
+  scheduledAt = now;
+
+  float blend = min(dt * 1000.0 / LF_CURVE_WINDOW_MS, 1.0);
+  curvature += ((correcting ? 1.0 : 0.0) - curvature) * blend;
+
+  float target = LF_SPEED_MAX - (LF_SPEED_MAX - LF_SPEED_MIN) * curvature;
+  if (feedSpeed > 0) {
+    target = feedSpeed;
+  }
+  if (target > scheduledSpeed) {
+    scheduledSpeed = min(target, scheduledSpeed + LF_ACCEL_PER_S * dt);
+  } else {
+    scheduledSpeed = max(target, scheduledSpeed - LF_DECEL_PER_S * dt);
+  }
+}
+
+/**
+ * A new correction: a bend is starting, so raise the estimate at once
+ */
+static void curveKick() {
+  curvature = min(curvature + LF_CURVE_KICK, 1.0);
+}
+
+// ============ JUNCTIONS ============
+
+// Action names in flash (order must match JunctionAction)
+static const char JUNCTION_NAMES[][9] PROGMEM = {
+  "straight", "left", "right", "U-turn", "stop"
+};
+
+const char* junctionActionName(JunctionAction action) {
+  return JUNCTION_NAMES[action];
+}
+
+/**
+ * A junction is under the robot: both IR sensors on a line (a crossing
+ * or T), or a marker patch under the color sensor. Only with a route,
+ * and not again while still clearing the last one.
+ */
+static bool junctionDetected(bool irLeft, bool irRight, ColorClass targetColor,
+                             ColorClass currentColor, unsigned long now) {
+  if (routeCount == 0 || now - junctionLeftMs < LF_JUNCTION_HOLDOFF_MS) {
+    return false;
+  }
+  if (irLeft && irRight) {
+    return true;
+  }
+  return currentColor != targetColor && (junctionMarkers & COLOR_SET(currentColor)) != 0;
+}
+
+/**
+ * Take the route's next action: drive on to the crossing (or straight
+ * across it), or stop if the route ends here
+ */
+static void junctionBegin() {
+  junctionAction = junctionCount < routeCount ? route[junctionCount] : JUNCTION_STRAIGHT;
+  junctionCount++;
+  LOG("[LF] Junction %u - " LOG_FSTR, junctionCount, junctionActionName(junctionAction));
+
+  if (junctionAction == JUNCTION_STOP) {
+    motorBrake();
+    currentLFState = STATE_LF_STOPPED;
+    return;
+  }
+  junctionPhase = JUNCTION_PHASE_CENTER;
+  motorMoveForwardTime(LINE_FOLLOW_SPEED,
+                       junctionAction == JUNCTION_STRAIGHT ? LF_JUNCTION_CLEAR_MS : LF_JUNCTION_CENTER_MS);
+  currentLFState = STATE_LF_JUNCTION;
+}
+
+/**
+ * Next junction step, once the last maneuver has finished
+ * @return true when the junction is cleared
+ */
+static bool junctionStep() {
+  if (junctionPhase == JUNCTION_PHASE_CENTER && junctionAction != JUNCTION_STRAIGHT) {
+    int degrees = junctionAction == JUNCTION_LEFT ? 90 : junctionAction == JUNCTION_RIGHT ? -90 : 180;
+    turnDegrees(LINE_FOLLOW_TURN_SPEED, degrees, LF_JUNCTION_TURN_90_MS);
+    junctionPhase = JUNCTION_PHASE_TURN;
+    return false;
+  }
+  // An under-turn leaves the branch on the side the robot turned to
+  if (junctionAction == JUNCTION_LEFT) {
+    lastSide = LINE_SIDE_LEFT;
+  } else if (junctionAction == JUNCTION_RIGHT) {
+    lastSide = LINE_SIDE_RIGHT;
+  }
+  return true;
+}
+
+// ============ LINE LOSS SEARCH ============
+
+/**
+ * Pivot one way or the other
+ */
+static void steerToward(LineSide side) {
+  if (side == LINE_SIDE_LEFT) {
+    steerLeft(LINE_FOLLOW_TURN_SPEED);
+  } else {
+    steerRight(LINE_FOLLOW_TURN_SPEED);
+  }
+}
+
+/**
+ * One step of the line-lost search, by time since it began
+ * Sweep: leg k pivots k * LF_SWEEP_STEP_MS, alternating sides and starting
+ * toward lastSide, so each swing reaches one step further out. Spiral:
+ * forward arc toward lastSide whose inner wheel speeds up, widening the
+ * circle. Past both, give up.
+ */
+static void lineSearchStep() {
+  unsigned long elapsed = millis() - searchStartMs;
+
+  unsigned long legEnd = 0;
+  for (uint8_t leg = 1; leg <= LF_SWEEP_LEGS; leg++) {
+    legEnd += (unsigned long)leg * LF_SWEEP_STEP_MS;
+    if (elapsed < legEnd) {
+      bool towardLast = leg % 2 == 1;
+      steerToward(towardLast ? lastSide : (lastSide == LINE_SIDE_LEFT ? LINE_SIDE_RIGHT : LINE_SIDE_LEFT));
+      return;
+    }
+  }
+
+  unsigned long spiral = elapsed - legEnd;
+  if (spiral < LF_SPIRAL_MS) {
+    int inner = LF_SPIRAL_INNER_MIN + (long)(LINE_FOLLOW_SPEED - LF_SPIRAL_INNER_MIN) * spiral / LF_SPIRAL_MS;
+    if (lastSide == LINE_SIDE_LEFT) {
+      motorDrive(inner, LINE_FOLLOW_SPEED);
+    } else {
+      motorDrive(LINE_FOLLOW_SPEED, inner);
+    }
+    return;
+  }
+
+  LOG("[LF] Line not found after %lu ms - stopping", elapsed);
+  motorStop();
+  currentLFState = STATE_LF_STOPPED;
 }
 
 // ============ LINE FOLLOW FSM ============
@@ -55,33 +328,87 @@ void lineFollowSetup() {
  *
  * @param targetColor The color of the line to follow (e.g. "BLACK")
  *
+ * Only the line color, the floor and any junction markers are expected
+ * under the sensor, so the read stops as soon as it can tell those apart.
+ */
+void lineFollowFSM(const char* targetColor) {
+  ColorClass target = colorFromName(targetColor);
+  ColorClass current = classifyAmong(COLOR_SET(target) | COLOR_SET(COLOR_WHITE) | junctionMarkers);
+  lineFollowStep(target, current);
+}
+
+/**
+ * One line follow step with a color the caller already classified
+ * For FSMs that read the sensor once per tick for their own checks too.
+ *
  * Algorithm:
- * - Robot moves forward while color sensor detects the target color
+ * - Robot moves forward while color sensor detects the target color, at a
+ *   speed scheduled from how much it has had to correct lately
  * - If left IR sensor goes LOW, the line is to the left -> correct left
  * - If right IR sensor goes LOW, the line is to the right -> correct right
  * - Correction continues until the color sensor detects the target color again
+ * - With a route, both IR sensors on (or a marker color) is a junction:
+ *   the route's action for it is taken, then following resumes
  */
-void lineFollowFSM(const char* targetColor) {
+void lineFollowStep(ColorClass targetColor, ColorClass currentColor) {
 
-  Serial.println(targetColor);
-  Serial.println(currentLFState);
+  LOG("[LF] target %s, state %d, speed %d", colorName(targetColor), currentLFState, (int)scheduledSpeed);
 
   bool irLeft = irLeftDetected();
   bool irRight = irRightDetected();
-  const char* currentColor = readDominantColor();
+  flightLive.irBits = (irLeft ? FR_IR_LEFT : 0) | (irRight ? FR_IR_RIGHT : 0);
+
+  if (!motorIdle()) {
+    return;  // Recovery back-up (or a brake) still running
+  }
+  if (watchdogCheck(&lfWatchdog, currentLFState)) {
+    lineFollowRecover();
+    return;
+  }
+
+  // Remember where and when the line was last seen; losing it for
+  // LF_LOST_AFTER_MS starts the search
+  unsigned long now = millis();
+  bool lineSeen = currentColor == targetColor || irLeft || irRight;
+  if (lineSeen) {
+    lastSeenMs = now;
+  } else if ((currentLFState == STATE_LF_FORWARD || currentLFState == STATE_LF_CORRECT_LEFT ||
+              currentLFState == STATE_LF_CORRECT_RIGHT) && now - lastSeenMs > LF_LOST_AFTER_MS) {
+    LOG("[LF] Line lost (last seen %lu ms ago)", now - lastSeenMs);
+    lineFollowSearch(lastSide);
+  }
+  scheduleSpeed(currentLFState != STATE_LF_FORWARD && currentLFState != STATE_LF_JUNCTION);
+
+  if ((currentLFState == STATE_LF_FORWARD || currentLFState == STATE_LF_CORRECT_LEFT ||
+       currentLFState == STATE_LF_CORRECT_RIGHT) &&
+      junctionDetected(irLeft, irRight, targetColor, currentColor, now)) {
+    junctionBegin();
+    return;
+  }
 
   switch (currentLFState) {
 
     case STATE_LF_FORWARD: {
-      motorMoveForward(LINE_FOLLOW_SPEED);
+      if (feedSpeed > 0 && feedCurve != 0) {
+        // Differential drive: wheel speeds v * (1 -/+ k * track / 2)
+        float spread = constrain(feedCurve * ODO_TRACK_MM / 2, -1.0, 1.0);
+        motorDrive(constrain((int)(scheduledSpeed * (1 - spread)), -255, 255),
+                   constrain((int)(scheduledSpeed * (1 + spread)), -255, 255));
+      } else {
+        motorMoveForward((int)scheduledSpeed);
+      }
 
-      if (strcmp(currentColor, targetColor) != 0) {  // Check IR sensors for line deviation
+      if (currentColor != targetColor) {  // Check IR sensors for line deviation
         if (irLeft) {
-          Serial.println("[LF] Left IR triggered - correcting left");
+          LOG("[LF] Left IR triggered - correcting left");
+          lastSide = LINE_SIDE_RIGHT;
+          curveKick();
           currentLFState = STATE_LF_CORRECT_RIGHT;
         }
         else if (irRight) {
-          Serial.println("[LF] Right IR triggered - correcting right");
+          LOG("[LF] Right IR triggered - correcting right");
+          lastSide = LINE_SIDE_LEFT;
+          curveKick();
           currentLFState = STATE_LF_CORRECT_LEFT;
         }
       }
@@ -92,8 +419,9 @@ void lineFollowFSM(const char* targetColor) {
       steerLeft(LINE_FOLLOW_TURN_SPEED);
 
       // Check if color sensor is back on the target line
-      if (strcmp(currentColor, targetColor) == 0 || !irLeft) {
-        Serial.println("[LF] Back on line - resuming forward");
+      if (currentColor == targetColor || !irLeft) {
+        LOG("[LF] Back on line - resuming forward");
+        recoverSteps = 0;
         currentLFState = STATE_LF_FORWARD;
       }
       break; }
@@ -103,8 +431,9 @@ void lineFollowFSM(const char* targetColor) {
       steerRight(LINE_FOLLOW_TURN_SPEED);
 
       // Check if color sensor is back on the target line
-      if (strcmp(currentColor, targetColor) == 0 || !irRight) {
-        Serial.println("[LF] Back on line - resuming forward");
+      if (currentColor == targetColor || !irRight) {
+        LOG("[LF] Back on line - resuming forward");
+        recoverSteps = 0;
         currentLFState = STATE_LF_FORWARD;
       }
       break; }
@@ -113,10 +442,29 @@ void lineFollowFSM(const char* targetColor) {
       motorStop();
       break; }
 
+    case STATE_LF_LOST: {
+      if (lineSeen) {
+        LOG("[LF] Line re-acquired after %lu ms", now - searchStartMs);
+        recoverSteps = 0;
+        currentLFState = STATE_LF_FORWARD;  // IR triggers correct from here
+        break;
+      }
+      lineSearchStep();
+      break; }
+
+    case STATE_LF_JUNCTION: {
+      if (junctionStep()) {
+        lastSeenMs = now;  // Time spent on the maneuver is not time lost
+        junctionLeftMs = now;
+        currentLFState = STATE_LF_FORWARD;
+      }
+      break; }
+
     default: {
-      Serial.println("[LF] ERROR: Unknown state");
+      LOG("[LF] ERROR: Unknown state");
       motorStop();
       currentLFState = STATE_LF_STOPPED;
+      flightRecorderDumpFinal();
       break; }
   }
 }
@@ -2,37 +2,116 @@
 #include <Arduino.h>
 #include "color_sensor_func.h"
 #include "line_follow_func.h"
+#include "flight_recorder.h"
+#include "task.h"
+#include "telemetry.h"
+#include "log_sink.h"
+#include "odometry.h"
+#include "turn_cal.h"
+#include "lap_memory.h"
+#include "route.h"
+
+static Task followTask;     // Line follow FSM, paced by CORRECTION_DELAY
+static Task telemetryLoop;  // Binary telemetry frames
+static Task logLoop;        // Log drain and periodic drop report
+static Task odometryLoop;   // Pose integration
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(TELEMETRY_BAUD);
   delay(200);
 
-  Serial.println("\n=== ROBOT MAIN PROGRAM STARTED ===");
-
-  // Initialize color sensor
-  pinMode(PIN_S0, OUTPUT);
-  pinMode(PIN_S1, OUTPUT);
-  pinMode(PIN_S2, OUTPUT);
-  pinMode(PIN_S3, OUTPUT);
-  pinMode(PIN_OUT, INPUT);
+  Serial.println(F("\n=== ROBOT MAIN PROGRAM STARTED ==="));
 
-  // Set frequency scaling to 20% (S0=HIGH, S1=LOW)
-  digitalWrite(PIN_S0, HIGH);
-  digitalWrite(PIN_S1, LOW);
+  // Initialize color sensor (pins, frequency scaling)
+  colorSensorSetup();
 
-  Serial.print("Color sensor initialized. Black threshold: ");
+  Serial.print(F("Color sensor initialized. Black threshold: "));
   Serial.println(BLACK_THRESHOLD);
+  if (colorCalibrationLoad()) {
+    Serial.println(F("Color calibration loaded from EEPROM"));
+  } else {
+    Serial.println(F("No color calibration - using black threshold (send 'c' to calibrate)"));
+  }
 
   // Initialize line follow system (IR sensors + motors)
   lineFollowSetup();
+  lapSetup();
+  routeSetup();
 
-  Serial.println("=== STARTING LINE FOLLOW ===\n");
+  Serial.println(F("=== STARTING LINE FOLLOW ===\n"));
   delay(500);
 }
 
 void loop() {
-  // Follow the black line
-  lineFollowFSM("BLACK");
+  // Check for serial commands
+  if (Serial.available() > 0) {
+    handleCommand(Serial.read());
+  }
+
+  // Cooperative tasks - none of these block
+  motorTask();
+  odometryTask(&odometryLoop);
+  if (turnCalActive()) {
+    turnCalTask();  // Owns the motors until done
+  } else {
+    lineFollowTask(&followTask);
+  }
+  telemetryTask(&telemetryLoop);
+  logSinkTask(&logLoop);
+}
+
+/**
+ * Follow the black line, one FSM step every CORRECTION_DELAY ms
+ */
+uint8_t lineFollowTask(Task* t) {
+  TASK_BEGIN(t);
+
+  while (true) {
+    lapUpdate();  // Learn the lap, or feed the learned one forward
+    lineFollowFSM("BLACK");
+    flightRecorderTick(lineFollowGetState());
+    TASK_AWAIT_MS(t, CORRECTION_DELAY);
+  }
+
+  TASK_END(t);
+}
+
+void handleCommand(char cmd) {
+  switch (cmd) {
+    case FR_DUMP_CMD:
+      flightRecorderDump();
+      break;
+
+    case TELEMETRY_CMD:
+      telemetrySetEnabled(!telemetryEnabled());
+      break;
+
+    case LOG_STATS_CMD:
+      logReport();
+      break;
+
+    case COLOR_CAL_CMD:
+      colorCalibrationCommand();
+      break;
+
+    case ODO_CMD:
+      odometryPrint();
+      break;
+
+    case TURN_CAL_CMD:
+      turnCalCommand();
+      break;
+
+    case WHEEL_CAL_CMD:
+      wheelCalCommand();
+      break;
+
+    case LAP_CMD:
+      lapCommand();
+      break;
 
-  delay(CORRECTION_DELAY);
+    case ROUTE_CMD:
+      routeCommand();
+      break;
+  }
 }
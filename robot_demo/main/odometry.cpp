@@ -0,0 +1,176 @@
+/* Dead-reckoning odometry: (x, y, heading) and covariance from commanded wheel PWM. */
+#include "odometry.h"
+
+// ============ ODOMETRY STATE ============
+static OdoPose pose = { 0, 0, 0 };
+static float cov[3][3] = { { 0 } };     // Covariance of (x, y, theta)
+static int wheelLeft = 0;               // Current wheel commands (signed PWM)
+static int wheelRight = 0;
+static unsigned long integratedAt = 0;  // millis() the pose is valid for
+static float travelled = 0;             // Path length of the robot center (mm)
+
+// ============ MODEL ============
+
+/**
+ * Modelled wheel speed for a signed PWM command
+ * @return mm/s, negative when driven backward
+ */
+float odometryWheelSpeed(int pwm) {
+  int magnitude = abs(pwm);
+  if (magnitude <= ODO_DEADBAND_PWM) {
+    return 0;
+  }
+  float speed = (magnitude - ODO_DEADBAND_PWM) * ODO_MM_PER_S_PWM;
+  return pwm > 0 ? speed : -speed;
+}
+
+/**
+ * Advance the pose to `now` with the current wheel commands
+ * Midpoint heading for the arc; covariance propagated with the motion
+ * Jacobian plus per-wheel slip proportional to distance.
+ */
+static void integrateTo(unsigned long now) {
+  float dt = (now - integratedAt) / 1000.0;
+  integratedAt = now;
+  if (dt <= 0) {
+    return;
+  }
+
+  float dl = odometryWheelSpeed(wheelLeft) * dt;
+  float dr = odometryWheelSpeed(wheelRight) * dt;
+  if (dl == 0 && dr == 0) {
+    return;
+  }
+  float ds = (dl + dr) / 2;
+  float dTheta = (dr - dl) / ODO_TRACK_MM;
+  float heading = pose.theta + dTheta / 2;
+  float c = cos(heading);
+  float s = sin(heading);
+
+  travelled += fabs(ds);
+  pose.x += ds * c;
+  pose.y += ds * s;
+  pose.theta += dTheta;
+
+  // P = F P F' with F = [1 0 -ds*s; 0 1 ds*c; 0 0 1]
+  float fx = -ds * s;
+  float fy = ds * c;
+  float p02 = cov[0][2] + fx * cov[2][2];
+  float p12 = cov[1][2] + fy * cov[2][2];
+  cov[0][0] += 2 * fx * cov[0][2] + fx * fx * cov[2][2];
+  cov[1][1] += 2 * fy * cov[1][2] + fy * fy * cov[2][2];
+  cov[0][1] += fx * cov[1][2] + fy * cov[0][2] + fx * fy * cov[2][2];
+  cov[0][2] = p02;
+  cov[1][2] = p12;
+
+  // + G Q G' with Q = diag(k|dl|, k|dr|)
+  float vl = ODO_SLIP_MM2_PER_MM * fabs(dl);
+  float vr = ODO_SLIP_MM2_PER_MM * fabs(dr);
+  float sum = (vl + vr) / 4;
+  float diff = (vr - vl) / (2 * ODO_TRACK_MM);
+  cov[0][0] += c * c * sum;
+  cov[1][1] += s * s * sum;
+  cov[0][1] += c * s * sum;
+  cov[0][2] += c * diff;
+  cov[1][2] += s * diff;
+  cov[2][2] += (vl + vr) / ((float)ODO_TRACK_MM * ODO_TRACK_MM);
+
+  cov[1][0] = cov[0][1];
+  cov[2][0] = cov[0][2];
+  cov[2][1] = cov[1][2];
+}
+
+// ============ RESETS ============
+
+/**
+ * Set a known pose with zero uncertainty
+ */
+void odometryReset(float x, float y, float theta) {
+  integratedAt = millis();
+  pose.x = x;
+  pose.y = y;
+  pose.theta = theta;
+  memset(cov, 0, sizeof(cov));
+}
+
+/**
+ * Position fix at a landmark; heading and its uncertainty are kept
+ */
+void odometryAnchor(float x, float y, float sigmaMm) {
+  integrateTo(millis());
+  pose.x = x;
+  pose.y = y;
+  cov[0][0] = sigmaMm * sigmaMm;
+  cov[1][1] = sigmaMm * sigmaMm;
+  cov[0][1] = cov[1][0] = 0;
+  cov[0][2] = cov[2][0] = 0;
+  cov[1][2] = cov[2][1] = 0;
+}
+
+// ============ INPUT ============
+
+/**
+ * Wheel command as requested from motor_func (before the wheel table)
+ * The pose is brought up to date first so each command is integrated
+ * over exactly the time it was applied.
+ */
+void odometrySetWheels(int left, int right) {
+  if (left == wheelLeft && right == wheelRight) {
+    return;
+  }
+  integrateTo(millis());
+  wheelLeft = left;
+  wheelRight = right;
+}
+
+// ============ ODOMETRY TASK ============
+
+/**
+ * Integrate every ODO_TICK_MS
+ * Call from loop() every pass
+ */
+uint8_t odometryTask(Task* t) {
+  TASK_BEGIN(t);
+
+  while (true) {
+    TASK_AWAIT_MS(t, ODO_TICK_MS);
+    integrateTo(millis());
+  }
+
+  TASK_END(t);
+}
+
+// ============ QUERIES ============
+
+OdoPose odometryPose() {
+  return pose;
+}
+
+float odometryDistance() {
+  return travelled;
+}
+
+float odometryPositionSigma() {
+  return sqrt(max(cov[0][0], cov[1][1]));
+}
+
+float odometryHeadingSigma() {
+  return sqrt(cov[2][2]);
+}
+
+/**
+ * Print pose and uncertainty
+ */
+void odometryPrint() {
+  Serial.print(F("[ODO] x: "));
+  Serial.print(pose.x, 0);
+  Serial.print(F(" mm  y: "));
+  Serial.print(pose.y, 0);
+  Serial.print(F(" mm  heading: "));
+  Serial.print(degrees(pose.theta), 1);
+  Serial.print(F(" deg  +/- "));
+  Serial.print(odometryPositionSigma(), 0);
+  Serial.print(F(" mm, "));
+  Serial.print(degrees(odometryHeadingSigma()), 1);
+  Serial.println(F(" deg"));
+}
@@ -0,0 +1,199 @@
+/* Route: fixed junction table, or Dijkstra over (junction, heading) for the cheapest path. */
+#include "route.h"
+#include "log_sink.h"
+
+// ============ COURSE ============
+// Example layout - replace with the real course. 0 is bottom left; the
+// robot comes up a start spur into 0 heading north. 2 to 5 also has a
+// loop around the right-hand side, leaving 2 east and entering 5 westward.
+//
+//   3 ---- 4 ---- 5 -.
+//   |      |      |  |
+//   0 ---- 1 ---- 2 -'
+//   |
+static const RouteEdge ROUTE_EDGES[] = {
+  { 0, ROUTE_NORTH, 3, ROUTE_NORTH, 400 },
+  { 1, ROUTE_NORTH, 4, ROUTE_NORTH, 400 },
+  { 2, ROUTE_NORTH, 5, ROUTE_NORTH, 400 },
+  { 0, ROUTE_EAST,  1, ROUTE_EAST,  500 },
+  { 1, ROUTE_EAST,  2, ROUTE_EAST,  500 },
+  { 3, ROUTE_EAST,  4, ROUTE_EAST,  500 },
+  { 4, ROUTE_EAST,  5, ROUTE_EAST,  500 },
+  { 2, ROUTE_EAST,  5, ROUTE_WEST,  900 },
+};
+#define ROUTE_NUM_EDGES (sizeof(ROUTE_EDGES) / sizeof(ROUTE_EDGES[0]))
+
+// Used with ROUTE_MODE_TABLE: one action per junction, in order
+static const JunctionAction ROUTE_TABLE[] = {
+  JUNCTION_STRAIGHT, JUNCTION_RIGHT, JUNCTION_STRAIGHT, JUNCTION_STOP
+};
+#define ROUTE_TABLE_STEPS (sizeof(ROUTE_TABLE) / sizeof(ROUTE_TABLE[0]))
+
+// ============ ROUTE STATE ============
+#define ROUTE_STATES (ROUTE_MAX_NODES * 4)  // (node, heading on arrival)
+#define ROUTE_NONE   255
+
+static JunctionAction routeActions[ROUTE_MAX_STEPS];
+static uint8_t routeSteps = 0;
+static uint16_t routeCostMm = 0;  // Planned cost (shortest path mode)
+
+// ============ PLANNING ============
+
+static uint16_t turnCost(uint8_t turn) {
+  if (turn == 0) {
+    return 0;
+  }
+  return turn == 2 ? ROUTE_U_TURN_COST_MM : ROUTE_TURN_COST_MM;
+}
+
+// Heading change (clockwise steps, 0-3) as the action that makes it
+static JunctionAction turnAction(uint8_t turn) {
+  static const JunctionAction ACTIONS[4] = {
+    JUNCTION_STRAIGHT, JUNCTION_RIGHT, JUNCTION_U_TURN, JUNCTION_LEFT
+  };
+  return ACTIONS[turn & 3];
+}
+
+/**
+ * Cheapest route from the start state to any arrival at the goal node
+ * Dijkstra over (node, arrival heading), since what a junction costs
+ * depends on which way the robot came in. Edges are relaxed both ways.
+ * @return false when the goal cannot be reached or the route is too long
+ */
+static bool routePlan() {
+  static_assert(ROUTE_STATES < ROUTE_NONE, "Route states must fit a byte");
+
+  uint16_t cost[ROUTE_STATES];
+  uint8_t prev[ROUTE_STATES];      // State this one was reached from
+  uint8_t prevExit[ROUTE_STATES];  // Heading it was left by
+  bool done[ROUTE_STATES];
+  for (uint8_t s = 0; s < ROUTE_STATES; s++) {
+    cost[s] = 0xFFFF;
+    prev[s] = ROUTE_NONE;
+    done[s] = false;
+  }
+
+  uint8_t start = ROUTE_START_NODE * 4 + ROUTE_START_HEADING;
+  uint8_t goal = ROUTE_NONE;
+  cost[start] = 0;
+
+  while (true) {
+    uint8_t s = ROUTE_NONE;
+    for (uint8_t i = 0; i < ROUTE_STATES; i++) {
+      if (!done[i] && cost[i] != 0xFFFF && (s == ROUTE_NONE || cost[i] < cost[s])) {
+        s = i;
+      }
+    }
+    if (s == ROUTE_NONE) {
+      break;  // Nothing left to reach
+    }
+    done[s] = true;
+    uint8_t node = s / 4;
+    uint8_t heading = s % 4;
+    if (node == ROUTE_GOAL_NODE) {
+      goal = s;
+      break;
+    }
+
+    for (uint8_t e = 0; e < ROUTE_NUM_EDGES; e++) {
+      const RouteEdge& edge = ROUTE_EDGES[e];
+      uint8_t exitHeading, to, arrive;
+      if (edge.from == node) {
+        exitHeading = edge.exitHeading;
+        to = edge.to;
+        arrive = edge.arriveHeading;
+      } else if (edge.to == node) {
+        exitHeading = (edge.arriveHeading + 2) % 4;  // Back the way it came in
+        to = edge.from;
+        arrive = (edge.exitHeading + 2) % 4;
+      } else {
+        continue;
+      }
+      if (to >= ROUTE_MAX_NODES) {
+        continue;
+      }
+
+      uint8_t next = to * 4 + arrive;
+      unsigned long c = (unsigned long)cost[s] + edge.lengthMm + turnCost((exitHeading + 4 - heading) % 4);
+      if (c < cost[next]) {
+        cost[next] = c;
+        prev[next] = s;
+        prevExit[next] = exitHeading;
+      }
+    }
+  }
+
+  if (goal == ROUTE_NONE) {
+    LOG("[ROUTE] Junction %u cannot be reached from %u", ROUTE_GOAL_NODE, ROUTE_START_NODE);
+    return false;
+  }
+
+  // Count the junctions on the path, then fill the actions back to front
+  uint8_t steps = 1;  // The stop at the goal
+  for (uint8_t s = goal; s != start; s = prev[s]) {
+    steps++;
+  }
+  if (steps > ROUTE_MAX_STEPS) {
+    LOG("[ROUTE] Route needs %u junctions, more than %u", steps, ROUTE_MAX_STEPS);
+    return false;
+  }
+
+  routeSteps = steps;
+  routeCostMm = cost[goal];
+  routeActions[--steps] = JUNCTION_STOP;
+  for (uint8_t s = goal; s != start; s = prev[s]) {
+    uint8_t from = prev[s];
+    routeActions[--steps] = turnAction((prevExit[s] + 4 - from % 4) % 4);
+  }
+  return true;
+}
+
+// ============ ROUTE ============
+
+void routeSetup() {
+  routeSteps = 0;
+  routeCostMm = 0;
+
+  if (ROUTE_MODE == ROUTE_MODE_TABLE) {
+    routeSteps = min(ROUTE_TABLE_STEPS, (size_t)ROUTE_MAX_STEPS);
+    memcpy(routeActions, ROUTE_TABLE, routeSteps * sizeof(JunctionAction));
+  } else if (ROUTE_MODE == ROUTE_MODE_SHORTEST && !routePlan()) {
+    routeSteps = 0;
+  }
+
+  lineFollowSetRoute(routeActions, routeSteps, routeSteps > 0 ? ROUTE_MARKERS : 0);
+  if (routeSteps > 0) {
+    routePrint();
+  } else {
+    Serial.println(F("[ROUTE] No route - junctions are not handled"));
+  }
+}
+
+void routeCommand() {
+  routeSetup();
+  lineFollowReset();
+}
+
+/**
+ * Print the actions, marking the next junction
+ */
+void routePrint() {
+  Serial.print(F("[ROUTE] "));
+  Serial.print(ROUTE_MODE == ROUTE_MODE_SHORTEST ? "Shortest path" : "Table");
+  Serial.print(F(", "));
+  Serial.print(routeSteps);
+  Serial.print(F(" junctions"));
+  if (ROUTE_MODE == ROUTE_MODE_SHORTEST) {
+    Serial.print(F(", cost "));
+    Serial.print(routeCostMm);
+    Serial.print(F(" mm"));
+  }
+  Serial.println();
+
+  for (uint8_t i = 0; i < routeSteps; i++) {
+    Serial.print(i == lineFollowJunctions() ? "> " : "  ");
+    Serial.print(i + 1);
+    Serial.print(F(": "));
+    Serial.println(FLASH_STR(junctionActionName(routeActions[i])));
+  }
+}
@@ -0,0 +1,60 @@
+/* Route: the turn to take at each junction of a line network, as a table or a shortest path. */
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include "Arduino.h"
+#include "line_follow_func.h"
+
+// ============ ROUTE CONFIGURATION ============
+// ROUTE_MODE_TABLE hands ROUTE_TABLE (route.cpp) to the line follower as
+// written. ROUTE_MODE_SHORTEST plans it from the course graph (ROUTE_EDGES,
+// route.cpp): the cheapest way from arriving at ROUTE_START_NODE heading
+// ROUTE_START_HEADING to ROUTE_GOAL_NODE, counting each turn as extra
+// distance, ending with a stop. The loop course has no junctions: off.
+#define ROUTE_MODE_OFF       0
+#define ROUTE_MODE_TABLE     1
+#define ROUTE_MODE_SHORTEST  2
+
+#define ROUTE_MODE           ROUTE_MODE_OFF
+#define ROUTE_CMD            'j'    // Serial command: re-plan, print, restart the route
+#define ROUTE_MARKERS        COLOR_SET(COLOR_GREEN)  // Junction patch colors (0 = IR only)
+#define ROUTE_MAX_NODES      16
+#define ROUTE_MAX_STEPS      16     // Longest route, in junctions
+#define ROUTE_START_NODE     0      // First junction reached
+#define ROUTE_START_HEADING  ROUTE_NORTH  // Heading when reaching it
+#define ROUTE_GOAL_NODE      5
+#define ROUTE_TURN_COST_MM   150    // A 90-degree turn takes as long as driving this far
+#define ROUTE_U_TURN_COST_MM 300
+
+// ============ COURSE GRAPH ============
+// Junctions are nodes; headings are course directions, clockwise so that
+// one step on is a right turn. Lines may bend between junctions, so an
+// edge gives the heading it leaves one end by and arrives at the other by.
+enum RouteHeading {
+  ROUTE_NORTH,
+  ROUTE_EAST,
+  ROUTE_SOUTH,
+  ROUTE_WEST
+};
+
+// A line between two junctions; drivable both ways
+struct RouteEdge {
+  uint8_t from;
+  uint8_t exitHeading;    // Leaving `from`
+  uint8_t to;
+  uint8_t arriveHeading;  // Reaching `to`
+  uint16_t lengthMm;
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Build the route for ROUTE_MODE and give it to the line follower - call after lineFollowSetup()
+void routeSetup();
+
+// Re-plan and restart the route from the start node
+void routeCommand();
+
+// Print the route's actions and how far along it the robot is
+void routePrint();
+
+#endif  // ROUTE_H
@@ -0,0 +1,263 @@
+/* Turn-rate and wheel-speed self-calibration: spin over a straight line and time the IR crossings. */
+#include "turn_cal.h"
+#include "motor_func.h"
+#include "line_follow_func.h"
+#include "log_sink.h"
+
+// ============ TURN CALIBRATION STATE ============
+static const uint8_t CAL_PWMS[TURN_CAL_POINTS] = TURN_CAL_PWMS;
+static const uint8_t WHEEL_PWMS[WHEEL_CAL_POINTS] = WHEEL_CAL_PWMS;
+
+static Task calTask;
+static bool active = false;
+static bool wheelMode = false;          // Running the wheel calibration
+static uint8_t point = 0;               // Index into CAL_PWMS / WHEEL_PWMS
+static uint8_t direction = 0;           // Turns: 0 = left, 1 = right. Wheels: wheel driven
+static unsigned long spinStart = 0;     // millis() timing started
+static TurnCalibration result;
+static uint16_t wheelRevMs[2][WHEEL_CAL_POINTS];  // Pivot ms/rev per wheel (0 = did not turn)
+
+// Per IR sensor [left, right]
+static bool onLine[2];                  // Last reading
+static uint8_t crossings[2];            // Line entries seen
+static unsigned long firstCrossing[2];  // millis() of the first
+static unsigned long lastCrossing[2];   // ... of the latest (debounce)
+static unsigned long lastFullTurn[2];   // ... of the latest odd one (whole turns after the first)
+
+// ============ CROSSING TIMING ============
+
+static void resetCrossings() {
+  onLine[0] = irLeftDetected();
+  onLine[1] = irRightDetected();
+  memset(crossings, 0, sizeof(crossings));
+}
+
+/**
+ * Count line entries of both sensors
+ * @return true once a sensor has timed `revs` revolutions
+ */
+static bool sampleCrossings(uint8_t revs) {
+  unsigned long now = millis();
+  bool seen[2] = { irLeftDetected(), irRightDetected() };
+
+  for (uint8_t s = 0; s < 2; s++) {
+    bool entered = seen[s] && !onLine[s];
+    onLine[s] = seen[s];
+    if (!entered || (crossings[s] > 0 && now - lastCrossing[s] < TURN_CAL_DEBOUNCE_MS)) {
+      continue;
+    }
+    if (crossings[s] == 0) {
+      firstCrossing[s] = now;
+    }
+    if (crossings[s] % 2 == 0) {
+      lastFullTurn[s] = now;
+    }
+    lastCrossing[s] = now;
+    crossings[s]++;
+    if (crossings[s] > 2 * revs) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * ms per revolution, averaged over the sensors that completed a turn
+ * @return 0 when neither did
+ */
+static uint16_t measuredRevMs() {
+  unsigned long total = 0;
+  uint8_t sensors = 0;
+  for (uint8_t s = 0; s < 2; s++) {
+    uint8_t turns = crossings[s] > 0 ? (crossings[s] - 1) / 2 : 0;
+    if (turns > 0) {
+      total += (lastFullTurn[s] - firstCrossing[s]) / turns;
+      sensors++;
+    }
+  }
+  return sensors ? (uint16_t)min(total / sensors, 65535UL) : 0;
+}
+
+static bool anyMeasured() {
+  for (uint8_t i = 0; i < TURN_CAL_POINTS; i++) {
+    if (result.revMs[0][i] || result.revMs[1][i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============ WHEEL TABLE ============
+
+/**
+ * PWM at which wheel w reaches `rate` (interpolated between measured points)
+ * @return 0 when the wheel never got that fast
+ */
+static uint8_t pwmForRate(uint8_t w, float rate) {
+  float lastRate = 0;
+  uint8_t lastPwm = 0;
+  for (uint8_t i = 0; i < WHEEL_CAL_POINTS; i++) {
+    if (wheelRevMs[w][i] == 0) {
+      continue;  // Still in the deadband
+    }
+    float pointRate = 1000.0 / wheelRevMs[w][i];
+    if (pointRate >= rate) {
+      if (lastPwm == 0) {
+        return WHEEL_PWMS[i];  // At or below the first moving point
+      }
+      return lastPwm + (WHEEL_PWMS[i] - lastPwm) * (rate - lastRate) / (pointRate - lastRate);
+    }
+    lastRate = pointRate;
+    lastPwm = WHEEL_PWMS[i];
+  }
+  return 0;
+}
+
+/**
+ * Build and store the wheel table from the pivot measurements
+ * Full speed (255) maps to the weaker wheel's top rate, so both wheels can
+ * follow every request; entry 0 is each wheel's first moving PWM.
+ * @return false when a wheel never turned
+ */
+static bool saveWheelTable() {
+  float topRate = 0;
+  for (uint8_t w = 0; w < 2; w++) {
+    uint16_t fastest = wheelRevMs[w][WHEEL_CAL_POINTS - 1];
+    if (fastest == 0) {
+      return false;
+    }
+    float rate = 1000.0 / fastest;
+    topRate = topRate == 0 ? rate : min(topRate, rate);
+  }
+
+  WheelCalibration table;
+  for (uint8_t w = 0; w < 2; w++) {
+    for (uint8_t k = 0; k < WHEEL_CAL_STEPS; k++) {
+      // Entry 0: the slowest the wheel can go
+      float rate = k == 0 ? 0 : topRate * k / (WHEEL_CAL_STEPS - 1);
+      table.pwm[w][k] = pwmForRate(w, rate);
+    }
+  }
+  motorWheelCalSave(&table);
+  return true;
+}
+
+// ============ CALIBRATION ============
+
+/**
+ * Start the calibration, or abort one in progress
+ */
+static void startCalibration(bool wheels) {
+  if (active) {
+    active = false;
+    motorStop();
+    Serial.println(F("[TURN CAL] Aborted"));
+    return;
+  }
+  memset(&result, 0, sizeof(result));
+  memcpy(result.pwm, CAL_PWMS, sizeof(result.pwm));
+  memset(wheelRevMs, 0, sizeof(wheelRevMs));
+  wheelMode = wheels;
+  taskReset(&calTask);
+  active = true;
+  if (wheels) {
+    Serial.println(F("[TURN CAL] Wheel calibration started - pivoting over the line on each wheel"));
+  } else {
+    Serial.println(F("[TURN CAL] Started - spinning over the line at each turn PWM"));
+  }
+}
+
+void turnCalCommand() {
+  startCalibration(false);
+}
+
+void wheelCalCommand() {
+  startCalibration(true);
+}
+
+bool turnCalActive() {
+  return active;
+}
+
+/**
+ * Pivot on each wheel at each raw WHEEL_PWMS value and time the crossings
+ * The table is saved when both wheels turned at full PWM.
+ */
+static uint8_t wheelCalTask() {
+  Task* t = &calTask;
+  TASK_BEGIN(t);
+
+  for (direction = 0; direction < 2; direction++) {
+    for (point = 0; point < WHEEL_CAL_POINTS; point++) {
+      if (direction == 0) {
+        motorDriveRaw(WHEEL_PWMS[point], 0);
+      } else {
+        motorDriveRaw(0, WHEEL_PWMS[point]);
+      }
+      TASK_AWAIT_MS(t, TURN_CAL_SPINUP_MS);
+
+      resetCrossings();
+      spinStart = millis();
+      TASK_AWAIT_UNTIL(t, sampleCrossings(WHEEL_CAL_REVS) || millis() - spinStart > TURN_CAL_TIMEOUT_MS);
+      motorStop();
+
+      wheelRevMs[direction][point] = measuredRevMs();
+      LOG("[TURN CAL] %s wheel PWM %u: %u ms/rev", direction == 0 ? "Left" : "Right",
+          WHEEL_PWMS[point], wheelRevMs[direction][point]);
+      TASK_AWAIT_MS(t, 500);
+    }
+  }
+
+  active = false;
+  if (saveWheelTable()) {
+    Serial.println(F("[TURN CAL] Wheel table saved to EEPROM - now run the turn calibration"));
+  } else {
+    Serial.println(F("[TURN CAL] A wheel never turned - is the robot over a line?"));
+  }
+
+  TASK_END(t);
+}
+
+/**
+ * Spin each direction at each CAL_PWMS value and time the crossings
+ * The record is saved when at least one point was measured.
+ */
+uint8_t turnCalTask() {
+  if (wheelMode) {
+    return wheelCalTask();
+  }
+
+  Task* t = &calTask;
+  TASK_BEGIN(t);
+
+  for (point = 0; point < TURN_CAL_POINTS; point++) {
+    for (direction = 0; direction < 2; direction++) {
+      if (direction == 0) {
+        motorTurnLeft(CAL_PWMS[point], TURN_CAL_TIMEOUT_MS + TURN_CAL_SPINUP_MS);
+      } else {
+        motorTurnRight(CAL_PWMS[point], TURN_CAL_TIMEOUT_MS + TURN_CAL_SPINUP_MS);
+      }
+      TASK_AWAIT_MS(t, TURN_CAL_SPINUP_MS);
+
+      resetCrossings();
+      spinStart = millis();
+      TASK_AWAIT_UNTIL(t, sampleCrossings(TURN_CAL_REVS) || millis() - spinStart > TURN_CAL_TIMEOUT_MS);
+      motorStop();
+
+      result.revMs[direction][point] = measuredRevMs();
+      LOG("[TURN CAL] PWM %u %s: %u ms/rev", CAL_PWMS[point], direction == 0 ? "left" : "right",
+          result.revMs[direction][point]);
+      TASK_AWAIT_MS(t, 500);
+    }
+  }
+
+  active = false;
+  if (anyMeasured()) {
+    motorTurnCalSave(&result);
+    Serial.println(F("[TURN CAL] Saved to EEPROM - turns use the measured rates"));
+  } else {
+    Serial.println(F("[TURN CAL] No crossings timed - is the robot over a line?"));
+  }
+
+  TASK_END(t);
+}
@@ -0,0 +1,39 @@
+/* Turn-rate and wheel-speed self-calibration: spin over a straight line and time the IR crossings. */
+#ifndef TURN_CAL_H
+#define TURN_CAL_H
+
+#include "Arduino.h"
+#include "task.h"
+
+// ============ TURN CALIBRATION CONFIGURATION ============
+// Park the robot with both IR sensors able to sweep across a straight line,
+// send 'r', and leave it. Each sensor crosses the line twice per
+// revolution, so every second crossing is one full turn whatever the offset.
+// Run 'w' (wheels) before 'r' (turns): turns are measured through the
+// wheel table.
+#define TURN_CAL_CMD         'r'    // Serial command: start / abort
+#define WHEEL_CAL_CMD        'w'    // Serial command: start / abort
+#define TURN_CAL_SPINUP_MS   400    // Ignore crossings while the spin speeds up
+#define TURN_CAL_REVS        3      // Revolutions timed per PWM and direction
+#define TURN_CAL_TIMEOUT_MS  15000  // Give up on a PWM that does not complete them
+#define TURN_CAL_DEBOUNCE_MS 40     // Line edges closer than this are one crossing
+
+// Wheel calibration pivots on one wheel while the other drives at each
+// raw PWM below; the rotation rate is proportional to that wheel's speed
+#define WHEEL_CAL_POINTS     7
+#define WHEEL_CAL_PWMS       { 50, 70, 90, 120, 160, 200, 255 }  // Ascending
+#define WHEEL_CAL_REVS       1      // Revolutions timed per wheel and PWM
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Start the turn / wheel calibration, or abort one in progress
+void turnCalCommand();
+void wheelCalCommand();
+
+// True while either calibration runs - the sketch must not drive the motors meanwhile
+bool turnCalActive();
+
+// Calibration task - call from loop() every pass while turnCalActive()
+uint8_t turnCalTask();
+
+#endif  // TURN_CAL_H
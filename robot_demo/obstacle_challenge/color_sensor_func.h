@@ -16,8 +16,71 @@
 #define BLACK_THRESHOLD 125  // If all RGB values above this, color is black
 #define PULSE_TIMEOUT 25000  // Timeout for pulseIn (microseconds)
 
+// Frequency scaling (S0/S1). All periods are reported as if read at
+// COLOR_SCALE_REFERENCE, so thresholds and calibration hold at any scaling.
+#define COLOR_SCALE_REFERENCE 20    // % - scaling the thresholds were tuned at
+#define COLOR_AUTO_SCALE      true  // Pick the scaling from the darkest R/G/B period of each reading
+#define COLOR_SCALE_UP_US     250   // Raw period above this -> next faster scaling
+#define COLOR_SCALE_DOWN_US   25    // Raw period below this -> next finer scaling
+
+// Calibration (nearest-centroid classifier)
+#define COLOR_CAL_CMD         'c'  // Serial command: start / sample next surface
+#define COLOR_CAL_SAMPLES     8    // Readings averaged per surface
+#define COLOR_CAL_VERSION     2  // 2: adds clear-filter periods
+#define COLOR_MAX_DISTANCE    250  // Per-mil; farther than this from every centroid -> UNKNOWN
+
+// Classify with the generated color_lut.h (tools/gen_color_lut.py) instead
+// of the EEPROM centroids: one table read, no arithmetic on class data
+#define COLOR_USE_LUT         false
+
+// classifyAmong(): per-filter period error, per-mil of the calibrated period
+#define COLOR_AMONG_MARGIN    150  // Candidates within this of the best match stay in the running
+#define COLOR_AMONG_MATCH     80   // A lone candidate this close ends the read early
+#define COLOR_AMONG_MAX_ERROR 400  // Best match worse than this -> UNKNOWN (surface not in the set)
+
+// Color classes (recorded as numbers by the flight recorder)
+enum ColorClass {
+  COLOR_UNKNOWN,
+  COLOR_BLACK,
+  COLOR_RED,
+  COLOR_GREEN,
+  COLOR_BLUE,
+  COLOR_WHITE,       // Floor / board
+  COLOR_CLASS_COUNT
+};
+
+// Set of candidate colors for classifyAmong()
+typedef uint8_t ColorSet;
+#define COLOR_SET(c) ((ColorSet)(1 << (c)))
+
 // function prototypes
+void colorSensorSetup();
 unsigned long readPulseUS();
-char* readDominantColor();
+const char* readDominantColor();
+ColorClass readColorClass();
+bool colorIsBlack();  // Single clear-filter read once calibrated
+ColorClass classifyAmong(ColorSet candidates);
+const char* colorName(ColorClass color);
+ColorClass colorFromName(const char* name);
+
+// Confidence of the last reading, 0-100 (0 when uncalibrated or UNKNOWN)
+uint8_t colorLastConfidence();
+
+// Filter reads the last classification took (1-4)
+uint8_t colorLastFilterReads();
+
+// millis() at the middle of the last classification's filter reads - when
+// the surface it reports was actually under the sensor
+unsigned long colorLastSampleMs();
+
+// Frequency scaling: 2, 20 or 100 (%)
+void colorSetScale(uint8_t percent);
+uint8_t colorScale();
+void colorSetAutoScale(bool enabled);
+
+// Calibration: load from EEPROM in setup(), step through surfaces with COLOR_CAL_CMD
+bool colorCalibrationLoad();
+bool colorCalibrated();
+void colorCalibrationCommand();
 
 #endif  // COLOR_SENSOR_FUNC_H
\ No newline at end of file
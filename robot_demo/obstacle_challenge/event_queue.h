@@ -0,0 +1,121 @@
+/* Lock-free single-producer/single-consumer event queue (ISR -> loop). Header-only. */
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdint.h>
+
+// ============ MEMORY ORDERING ============
+// AVR is single core: 8-bit loads/stores are atomic and an ISR cannot be
+// interrupted by loop(), so only compiler reordering must be prevented.
+// Elsewhere (ARM, ESP32, host) a full fence orders the slot copy against
+// the index publish.
+#if defined(__AVR__)
+  #include <util/atomic.h>
+  #define EVENT_QUEUE_FENCE() __asm__ __volatile__("" ::: "memory")
+#else
+  #define EVENT_QUEUE_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// ============ EVENT RECORD ============
+// Suggested payload for sensor ISRs: timestamp, source and a small value.
+enum EventSource {
+  EVENT_COLOR_EDGE,   // TCS3200 OUT edge (pin 2)
+  EVENT_IR_CHANGE,    // IR sensor pin change (value = FR_IR_* bits)
+  EVENT_ECHO_EDGE     // Ultrasonic echo edge (value = pin level)
+};
+
+struct SensorEvent {
+  uint32_t timeUs;  // micros() captured in the ISR
+  uint8_t source;   // EventSource
+  uint8_t value;    // Source-specific payload
+};
+
+// ============ QUEUE ============
+// Exactly one producer (usually an ISR) calls push(); exactly one consumer
+// (usually loop()) calls pop()/popBatch(). No allocation, no locks.
+// Indices run freely and wrap at 256, so CAPACITY must be a power of two
+// no larger than 128, and every slot is usable.
+template <typename T, uint8_t CAPACITY>
+class EventQueue {
+  static_assert(CAPACITY >= 2 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "EventQueue CAPACITY must be a power of two in [2, 128]");
+
+ public:
+  EventQueue() : head(0), tail(0), overflowCount(0) {}
+
+  // Producer: append one item. Returns false (and counts) when full.
+  bool push(const T& item) {
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) == CAPACITY) {
+      if (overflowCount != 0xFFFF) {
+        overflowCount++;
+      }
+      return false;
+    }
+    buffer[h & MASK] = item;
+    EVENT_QUEUE_FENCE();  // Slot written before it is published
+    head = h + 1;
+    return true;
+  }
+
+  // Consumer: remove the oldest item. Returns false when empty.
+  bool pop(T& item) {
+    uint8_t t = tail;
+    if (t == head) {
+      return false;
+    }
+    EVENT_QUEUE_FENCE();  // Index read before slot contents
+    item = buffer[t & MASK];
+    EVENT_QUEUE_FENCE();  // Slot copied before it is released
+    tail = t + 1;
+    return true;
+  }
+
+  // Consumer: remove up to maxItems items in one pass. Returns count copied.
+  uint8_t popBatch(T* out, uint8_t maxItems) {
+    uint8_t t = tail;
+    uint8_t available = (uint8_t)(head - t);
+    uint8_t n = available < maxItems ? available : maxItems;
+    EVENT_QUEUE_FENCE();
+    for (uint8_t i = 0; i < n; i++) {
+      out[i] = buffer[(uint8_t)(t + i) & MASK];
+    }
+    EVENT_QUEUE_FENCE();
+    tail = t + n;
+    return n;
+  }
+
+  // Items waiting (exact for the consumer, a lower bound for the producer)
+  uint8_t size() const {
+    return (uint8_t)(head - tail);
+  }
+
+  bool empty() const {
+    return head == tail;
+  }
+
+  // Pushes rejected because the queue was full (saturates at 65535).
+  // Only the producer writes it; compare against a previous reading
+  // rather than resetting it from the consumer.
+  uint16_t overflows() const {
+#if defined(__AVR__)
+    uint16_t count;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      count = overflowCount;
+    }
+    return count;
+#else
+    return overflowCount;
+#endif
+  }
+
+ private:
+  static const uint8_t MASK = CAPACITY - 1;
+
+  T buffer[CAPACITY];
+  volatile uint8_t head;            // Written only by the producer
+  volatile uint8_t tail;            // Written only by the consumer
+  volatile uint16_t overflowCount;  // Written only by the producer
+};
+
+#endif  // EVENT_QUEUE_H
@@ -0,0 +1,113 @@
+/* Flight recorder: keeps the last FR_CAPACITY ticks for post-mortem debugging. */
+#include "flight_recorder.h"
+#include "crc16.h"
+
+// ============ RECORDER STATE ============
+FlightFrame flightLive;                      // Latest sensor/motor values
+static FlightFrame frames[FR_CAPACITY];      // Ring buffer
+static uint8_t head = 0;                     // Next slot to write
+static uint8_t count = 0;                    // Valid frames in ring
+static unsigned long ticks = 0;              // Total ticks recorded
+static bool frozen = false;
+static bool finalDumped = false;
+
+// ============ RECORDING ============
+
+/**
+ * Stamp the live frame and copy it into the ring
+ * Just a struct copy - safe to call every loop
+ */
+void flightRecorderTick(uint8_t state) {
+  if (frozen) {
+    return;
+  }
+
+  flightLive.timeMs = millis();
+  flightLive.state = state;
+  frames[head] = flightLive;
+
+  head++;
+  if (head == FR_CAPACITY) {
+    head = 0;
+  }
+  if (count < FR_CAPACITY) {
+    count++;
+  }
+  ticks++;
+}
+
+void flightRecorderFreeze() {
+  frozen = true;
+}
+
+void flightRecorderResume() {
+  if (!finalDumped) {
+    frozen = false;
+  }
+}
+
+// ============ DUMP ============
+
+/**
+ * Write bytes to Serial while folding them into the CRC
+ */
+static uint16_t writeBytes(uint16_t crc, const void* data, uint8_t len) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (uint8_t i = 0; i < len; i++) {
+    Serial.write(bytes[i]);
+    crc = crc16Update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+/**
+ * Write the frozen ring to Serial, oldest frame first
+ * Decode on the host with tools/flight_decode.py
+ */
+static void writeDump() {
+  uint8_t version = FR_VERSION;
+  uint8_t frameSize = sizeof(FlightFrame);
+  uint16_t frameCount = count;
+  uint32_t totalTicks = ticks;
+
+  Serial.println();
+  Serial.write((const uint8_t*)FR_MAGIC, 4);
+
+  uint16_t crc = CRC16_INIT;
+  crc = writeBytes(crc, &version, 1);
+  crc = writeBytes(crc, &frameSize, 1);
+  crc = writeBytes(crc, &frameCount, 2);
+  crc = writeBytes(crc, &totalTicks, 4);
+
+  uint8_t index = (head + FR_CAPACITY - count) % FR_CAPACITY;
+  for (uint8_t i = 0; i < count; i++) {
+    crc = writeBytes(crc, &frames[index], sizeof(FlightFrame));
+    index = (index + 1) % FR_CAPACITY;
+  }
+
+  Serial.write((uint8_t)(crc & 0xFF));
+  Serial.write((uint8_t)(crc >> 8));
+  Serial.println();
+}
+
+/**
+ * Freeze, dump, and resume recording (serial request)
+ */
+void flightRecorderDump() {
+  bool wasFrozen = frozen;
+  frozen = true;
+  writeDump();
+  frozen = wasFrozen;
+}
+
+/**
+ * Freeze for good and dump once (fault or completion)
+ */
+void flightRecorderDumpFinal() {
+  if (finalDumped) {
+    return;
+  }
+  frozen = true;
+  finalDumped = true;
+  writeDump();
+}
@@ -0,0 +1,56 @@
+/* FSM instrumentation: per-state entry count, dwell time and transition counts. */
+#ifndef FSM_STATS_H
+#define FSM_STATS_H
+
+#include "Arduino.h"
+#include "state_watchdog.h"
+
+// ============ FSM STATS CONFIGURATION ============
+#define FSM_STATS_CMD        's'  // Serial command that prints the stats table
+
+// ============ FSM STATS RECORD ============
+// One instance per FSM. The FSM owns the counter storage, sized to its own
+// state count, and room for the distinct transitions it can make: only
+// transitions that happen are stored. Counts saturate to keep RAM low.
+struct FsmStateStats {
+  uint16_t entries;       // Times the state was entered
+  unsigned long totalMs;  // Total dwell
+  unsigned long maxMs;    // Longest single dwell
+};
+
+struct FsmTransition {
+  uint8_t from;
+  uint8_t to;
+  uint8_t count;          // Saturates at 255
+};
+
+struct FsmStats {
+  const StateName* names;       // State names in flash, indexed by state value
+  FsmStateStats* states;        // numStates entries
+  FsmTransition* transitions;   // maxTransitions entries
+  uint8_t numStates;
+  uint8_t maxTransitions;
+  uint8_t numTransitions;       // Distinct transitions stored so far
+  uint8_t current;              // State the FSM is currently in
+  bool printed;                 // Completion table already printed
+  uint16_t untracked;           // Transitions not counted: table full
+  unsigned long runStart;       // millis() at fsmStatsBegin()
+  unsigned long enteredAt;      // millis() when current state was entered
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Reset all counters and start timing in the given initial state
+void fsmStatsBegin(FsmStats* stats, const StateName* names, FsmStateStats* states, uint8_t numStates,
+                   FsmTransition* transitions, uint8_t maxTransitions, uint8_t initialState);
+
+// Call at the top of every FSM tick with the current state value
+void fsmStatsUpdate(FsmStats* stats, uint8_t state);
+
+// Print the stats table (includes the in-progress dwell of the current state)
+void fsmStatsPrint(FsmStats* stats);
+
+// Print the table once, e.g. when the FSM reaches its complete state
+void fsmStatsPrintOnce(FsmStats* stats);
+
+#endif  // FSM_STATS_H
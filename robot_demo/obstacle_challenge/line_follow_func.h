@@ -3,6 +3,7 @@
 
 #include "Arduino.h"
 #include "motor_func.h"
+#include "color_sensor_func.h"
 #include <string.h>
 
 // ============ IR SENSOR PIN DEFINITIONS ============
@@ -10,16 +11,76 @@
 #define IR_RIGHT_PIN A2   // Right IR sensor
 
 // ============ LINE FOLLOW CONFIGURATION ============
-#define LINE_FOLLOW_SPEED      110  // Forward speed (0-255)
+#define LINE_FOLLOW_SPEED      110  // Recovery and search speed (0-255); following is scheduled below
 #define LINE_FOLLOW_TURN_SPEED 110  // Correction turn speed (0-255)
 #define CORRECTION_DELAY       50   // ms between corrections
 
+// ============ SPEED SCHEDULING ============
+// Curvature is estimated from the share of recent time spent correcting (an
+// average over LF_CURVE_WINDOW_MS) plus a kick for each new correction, so
+// frequent or long corrections both read as a bend. Forward speed runs from
+// LF_SPEED_MAX on a straight down to LF_SPEED_MIN at full curvature,
+// rate-limited: slowing is quicker than speeding up.
+#define LF_SPEED_MIN           90    // Forward speed in the tightest bends
+#define LF_SPEED_MAX           170   // Forward speed on straights
+#define LF_CURVE_WINDOW_MS     600   // Time constant of the correction average
+#define LF_CURVE_KICK          0.25  // Added to the estimate (0-1) per new correction
+#define LF_ACCEL_PER_S         150   // Max speed-up, PWM per second
+#define LF_DECEL_PER_S         600   // Max slow-down, PWM per second
+
+// ============ LINE FOLLOW WATCHDOG ============
+// A correction that never gets back to the line spins in place. Past the
+// budget the robot backs up and re-acquires from STATE_LF_FORWARD; each
+// consecutive recovery backs up one step further.
+#define LF_CORRECT_BUDGET_MS    1500  // Longest single correction
+#define LF_CORRECT_BUDGET_TICKS 0     // Ticks depend on the caller's rate: time only
+#define LF_RECOVER_REVERSE_MS   250   // Back-up per recovery step
+#define LF_RECOVER_MAX_STEPS    3     // Longest back-up, in steps
+
+// ============ LINE LOSS RECOVERY ============
+// Neither IR sensor nor the color sensor on the line for LF_LOST_AFTER_MS:
+// sweep toward the side the line was last steered to, swinging further on
+// each leg (LF_SWEEP_STEP_MS more per leg), then spiral outward the same
+// way. Both phases are time-bounded; after them the follower stops.
+#define LF_LOST_AFTER_MS        300   // Line unseen this long = lost
+#define LF_SWEEP_STEP_MS        150   // Pivot time added per sweep leg
+#define LF_SWEEP_LEGS           5     // Odd: the last leg swings toward the last-seen side
+#define LF_SPIRAL_MS            6000  // Outward spiral after the sweep
+#define LF_SPIRAL_INNER_MIN     20    // Inner wheel speed at the start of the spiral
+
+// ============ JUNCTIONS ============
+// Only once a route is set (lineFollowSetRoute): both IR sensors on the line
+// at once, or a marker color under the color sensor, is a junction, and the
+// route's next action is taken there. Turns first drive on until the axle
+// is over the crossing. Without a route the left IR wins, as before.
+#define LF_JUNCTION_CENTER_MS   180   // Drive on from detection to put the axle on the junction
+#define LF_JUNCTION_CLEAR_MS    250   // Drive straight across
+#define LF_JUNCTION_HOLDOFF_MS  400   // Ignore detections this long after a junction
+#define LF_JUNCTION_TURN_90_MS  500   // ms for a 90-degree turn (until turn-calibrated)
+
 // ============ LINE FOLLOW STATES ============
 enum LineFollowState {
   STATE_LF_FORWARD,        // Moving forward on the line
   STATE_LF_CORRECT_LEFT,   // Left IR triggered - correct left
   STATE_LF_CORRECT_RIGHT,  // Right IR triggered - correct right
-  STATE_LF_STOPPED         // Line following stopped
+  STATE_LF_STOPPED,        // Line following stopped
+  STATE_LF_LOST,           // Line lost - sweeping, then spiralling, to find it
+  STATE_LF_JUNCTION        // At a junction - taking the route's action
+};
+
+// Side of the robot the line was last seen on (the way it last had to steer)
+enum LineSide {
+  LINE_SIDE_LEFT,
+  LINE_SIDE_RIGHT
+};
+
+// What to do at a junction, relative to the way the robot arrived
+enum JunctionAction {
+  JUNCTION_STRAIGHT,
+  JUNCTION_LEFT,
+  JUNCTION_RIGHT,
+  JUNCTION_U_TURN,
+  JUNCTION_STOP      // Route done: stop in STATE_LF_STOPPED
 };
 
 // ============ FUNCTION PROTOTYPES ============
@@ -29,6 +90,36 @@ void lineFollowSetup();
 
 // Line follow FSM - takes target line color as parameter
 void lineFollowFSM(const char* targetColor);
+void lineFollowStep(ColorClass targetColor, ColorClass currentColor);
+LineFollowState lineFollowGetState();
+
+// Restart from STATE_LF_FORWARD, e.g. when an FSM hands the wheels back
+void lineFollowReset();
+
+// Start the line-lost search toward `side` (e.g. after a dodge); keep
+// calling lineFollowStep() - it leaves STATE_LF_LOST when the line is found,
+// or stops in STATE_LF_STOPPED when the search runs out
+void lineFollowSearch(LineSide side);
+
+// Feed-forward for STATE_LF_FORWARD from a known course (lap_memory): drive
+// at `speed` along an arc of `curvePerMm` (rad/mm, + left); the IR
+// corrections still apply. speed 0 returns to the curvature schedule.
+void lineFollowFeedForward(int speed, float curvePerMm);
+
+// Route: one action per junction, in the order they are reached (the
+// caller keeps `actions` alive). `markers` are colors that mark a junction
+// besides both IR sensors on. Past the last action junctions go straight.
+// count 0 turns junction handling off. Restarts the junction count.
+void lineFollowSetRoute(const JunctionAction* actions, uint8_t count, ColorSet markers);
+uint8_t lineFollowJunctions();  // Junctions reached since the route was set
+const char* junctionActionName(JunctionAction action);  // In flash: print with FLASH_STR()
+
+// Current scheduled forward speed and curvature estimate (0 straight - 1 tight)
+int lineFollowSpeed();
+float lineFollowCurvature();
+
+// Print correction watchdog trips
+void lineFollowPrintWatchdog();
 
 // IR sensor reading
 bool irLeftDetected();
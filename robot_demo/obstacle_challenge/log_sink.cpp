@@ -0,0 +1,118 @@
+/* Non-blocking log sink: whole messages in (or dropped and counted), drained as the UART allows. */
+#include "log_sink.h"
+#include <stdarg.h>
+
+// ============ RING BUFFER ============
+// Messages are stored as [length][text...]; a message is queued whole or
+// not at all, and freed once its last byte went to the UART.
+static uint8_t ring[LOG_BUFFER_SIZE];
+static uint16_t head = 0;       // Next byte to write
+static uint16_t tail = 0;       // Next byte to send
+static uint16_t used = 0;       // Bytes in ring
+static uint16_t highWater = 0;  // Largest `used` seen
+static unsigned long dropped = 0;
+static uint8_t sentOfMessage = 0;  // Bytes of the oldest message already sent
+
+static void ringPut(uint8_t b) {
+  ring[head] = b;
+  head = (head + 1) % LOG_BUFFER_SIZE;
+}
+
+// ============ WRITE SIDE ============
+
+/**
+ * Format one line and queue it, or drop it whole if it does not fit
+ */
+void logLineP(const char* fmt, ...) {
+  char message[LOG_MAX_MESSAGE];
+
+  va_list args;
+  va_start(args, fmt);
+#if defined(__AVR__)
+  int len = vsnprintf_P(message, sizeof(message) - 2, fmt, args);
+#else
+  int len = vsnprintf(message, sizeof(message) - 2, fmt, args);
+#endif
+  va_end(args);
+
+  if (len < 0) {
+    return;
+  }
+  len = min(len, (int)sizeof(message) - 3);
+  message[len++] = '\r';
+  message[len++] = '\n';
+
+  if (used + len + 1 > LOG_BUFFER_SIZE) {
+    dropped++;
+    return;
+  }
+
+  ringPut((uint8_t)len);
+  for (int i = 0; i < len; i++) {
+    ringPut((uint8_t)message[i]);
+  }
+  used += len + 1;
+  if (used > highWater) {
+    highWater = used;
+  }
+}
+
+// ============ DRAIN SIDE ============
+
+/**
+ * Send queued bytes while the UART TX buffer has room
+ * Serial.write() never blocks here because the space is checked first;
+ * a message longer than the free space is sent over several passes.
+ */
+static void drain() {
+  while (used > 0) {
+    uint8_t len = ring[tail];
+    int room = Serial.availableForWrite();
+    if (room <= 0) {
+      return;
+    }
+
+    uint8_t chunk = min(room, len - sentOfMessage);
+    uint16_t start = (tail + 1 + sentOfMessage) % LOG_BUFFER_SIZE;
+    uint16_t firstPart = min((uint16_t)chunk, (uint16_t)(LOG_BUFFER_SIZE - start));
+    Serial.write(&ring[start], firstPart);
+    if (firstPart < chunk) {
+      Serial.write(&ring[0], chunk - firstPart);
+    }
+
+    sentOfMessage += chunk;
+    if (sentOfMessage < len) {
+      return;
+    }
+
+    tail = (tail + len + 1) % LOG_BUFFER_SIZE;
+    used -= len + 1;
+    sentOfMessage = 0;
+  }
+}
+
+/**
+ * Drain whenever there is room, report counters every LOG_REPORT_MS
+ */
+uint8_t logSinkTask(Task* t) {
+  drain();
+
+  TASK_BEGIN(t);
+  while (true) {
+    TASK_AWAIT_MS(t, LOG_REPORT_MS);
+    logReport();
+  }
+  TASK_END(t);
+}
+
+void logReport() {
+  LOG("[LOG] dropped: %lu  high-water: %u/%u bytes", dropped, highWater, LOG_BUFFER_SIZE);
+}
+
+unsigned long logDropped() {
+  return dropped;
+}
+
+uint16_t logHighWater() {
+  return highWater;
+}
@@ -0,0 +1,57 @@
+/* Non-blocking log sink: loop() formats into a RAM ring, the UART drains it when idle. */
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include "Arduino.h"
+#include "task.h"
+
+// ============ LOG SINK CONFIGURATION ============
+#define LOG_BUFFER_SIZE  128   // Ring bytes (each message costs length + 1; holds one LOG_MAX_MESSAGE)
+#define LOG_MAX_MESSAGE  80    // Longer messages are truncated
+#define LOG_REPORT_MS    5000  // Interval of the drop/high-water report
+#define LOG_STATS_CMD    'l'   // Serial command: print the report now
+
+// ============ LOGGING ============
+// LOG("fmt", args...) appends one line. It never waits on the UART: when
+// the ring is full the whole message is dropped and counted.
+// Format strings live in flash on AVR; %f is not supported there.
+#if defined(__AVR__)
+  #include <avr/pgmspace.h>
+  #define LOG(fmt, ...) logLineP(PSTR(fmt), ##__VA_ARGS__)
+#else
+  #define LOG(fmt, ...) logLineP(fmt, ##__VA_ARGS__)
+#endif
+
+// Setup-time banners and on-demand diagnostic tables (stats, recorder dump)
+// still use Serial directly; anything that runs inside loop() uses LOG.
+
+// ============ FLASH STRINGS ============
+// Name tables kept in flash (PROGMEM) are printed with FLASH_STR(name) and
+// passed to LOG through the LOG_FSTR conversion. Literal Serial output uses
+// F("...") so it stays out of SRAM as well.
+#if defined(__AVR__)
+  #define FLASH_STR(s)    ((const __FlashStringHelper*)(s))
+  #define FLASH_STRLEN(s) strlen_P(s)
+  #define LOG_FSTR        "%S"
+#else
+  #define FLASH_STR(s)    (s)
+  #define FLASH_STRLEN(s) strlen(s)
+  #define LOG_FSTR        "%s"
+#endif
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Format (flash format string on AVR) and queue one line
+void logLineP(const char* fmt, ...);
+
+// Drain task - call from loop() every pass; also sends the periodic report
+uint8_t logSinkTask(Task* t);
+
+// Print drop count and high-water mark through the sink
+void logReport();
+
+// Counters
+unsigned long logDropped();
+uint16_t logHighWater();
+
+#endif  // LOG_SINK_H
@@ -4,25 +4,79 @@
 #include "motor_func.h"
 #include "ultrasonic_sensor_func.h"
 #include "line_follow_func.h"
+#include "fsm_stats.h"
+#include "state_watchdog.h"
+#include "color_vote.h"
+#include "flight_recorder.h"
+#include "log_sink.h"
+#include "task.h"
 #include <string.h>
 
 // ============ FSM STATE VARIABLES ============
 static ObstacleState state = OBS_FOLLOW_RED;
 static int blueCount = 0;             // Track blue zone encounters
 static unsigned long dodgeTimer = 0;  // Timer for timed dodge movements
+static FsmStats obsStats;             // Per-state dwell and transition counts
+static FsmStateStats obsStateStats[OBS_COMPLETE + 1];
+static FsmTransition obsTransitions[OBS_STATS_TRANSITIONS];
+static Task obsTask;                  // Resume point of the obstacle task
+static ColorClass seen = COLOR_UNKNOWN;  // This tick's color reading
+static ColorVote obsVote;             // Filtered zone color while following
+static StateWatchdog obsWatchdog;     // Per-state budgets
+static bool overBudget = false;       // This tick's state has overrun its budget
+static uint8_t findRedRecoveries = 0; // Watchdog recoveries in the current line search
+static bool findRedBackward = false;  // Searching in reverse
+static int findRedAlignDeg = 90;      // Right turn from the search heading to the course
+
+// Voting rules {enter, leave} of the last VOTE_WINDOW readings, by ColorClass
+static const ColorVoteRule OBS_VOTE_RULES[COLOR_CLASS_COUNT] = {
+  { 0, 0 },  // UNKNOWN
+  { 4, 6 },  // BLACK - ends the course, so demand a clear majority
+  { 3, 3 },  // RED
+  { 0, 0 },  // GREEN - not on this course
+  { 3, 5 },  // BLUE - sticky, so one zone is counted once
+  { 3, 3 },  // WHITE
+};
+
+// Surfaces each state can expect under the sensor (classifyAmong candidates)
+#define OBS_FOLLOW_COLORS (COLOR_SET(COLOR_RED) | COLOR_SET(COLOR_BLUE) | COLOR_SET(COLOR_BLACK) | COLOR_SET(COLOR_WHITE))
+#define OBS_SEARCH_COLORS (COLOR_SET(COLOR_RED) | COLOR_SET(COLOR_WHITE))
+
+// State names for the stats table (order must match ObstacleState)
+static const StateName OBS_STATE_NAMES[] PROGMEM = {
+  "FOLLOW_RED", "PICKUP_BOX", "DROPOFF_BOX", "DODGE_TURN_RIGHT",
+  "DODGE_PASS_SIDE", "DODGE_TURN_FORWARD", "DODGE_PASS_LENGTH",
+  "DODGE_TURN_TO_LINE", "DODGE_FIND_RED", "DODGE_ALIGN", "COMPLETE"
+};
+
+// Budget {ms, ticks} per visit, by ObstacleState (0 = no limit). The other
+// states end on their own timers.
+static const StateBudget OBS_BUDGETS[] PROGMEM = {
+  { 0, 0 },  // FOLLOW_RED - the whole course
+  { 0, 0 },  // PICKUP_BOX
+  { 0, 0 },  // DROPOFF_BOX
+  { 0, 0 },  // DODGE_TURN_RIGHT
+  { 0, 0 },  // DODGE_PASS_SIDE
+  { 0, 0 },  // DODGE_TURN_FORWARD
+  { 0, 0 },  // DODGE_PASS_LENGTH
+  { 0, 0 },  // DODGE_TURN_TO_LINE
+  { OBS_FIND_RED_BUDGET_MS, OBS_FIND_RED_BUDGET_TICKS },  // DODGE_FIND_RED
+  { 0, 0 },  // DODGE_ALIGN
+  { 0, 0 },  // COMPLETE
+};
 
 // ============ COLOR HELPERS ============
 
 bool obsIsRed() {
-  return strcmp(readDominantColor(), "RED") == 0;
+  return classifyAmong(OBS_SEARCH_COLORS) == COLOR_RED;
 }
 
 bool obsIsBlue() {
-  return strcmp(readDominantColor(), "BLUE") == 0;
+  return classifyAmong(OBS_FOLLOW_COLORS) == COLOR_BLUE;
 }
 
 bool obsIsBlack() {
-  return strcmp(readDominantColor(), "BLACK") == 0;
+  return colorIsBlack();
 }
 
 // ============ SETUP ============
@@ -35,219 +89,313 @@ void obstacleSetup() {
   state = OBS_FOLLOW_RED;
   blueCount = 0;
   dodgeTimer = 0;
+  taskReset(&obsTask);
+  fsmStatsBegin(&obsStats, OBS_STATE_NAMES, obsStateStats, OBS_COMPLETE + 1,
+                obsTransitions, OBS_STATS_TRANSITIONS, state);
+  watchdogBegin(&obsWatchdog, "OBS", OBS_STATE_NAMES, OBS_BUDGETS, OBS_COMPLETE + 1, state);
+  colorVoteBegin(&obsVote, OBS_VOTE_RULES);
+  lineFollowReset();
 
   motorStop();
-  Serial.println("[OBS] Obstacle course FSM initialized");
+  Serial.println(F("[OBS] Obstacle course FSM initialized"));
 }
 
-// ============ OBSTACLE COURSE FSM ============
+/**
+ * Current FSM state (for recording/instrumentation)
+ */
+ObstacleState obstacleGetState() {
+  return state;
+}
 
-void navigateObstacleFSM() {
+/**
+ * Print per-state dwell time and transition counts
+ * Called automatically on completion, or on serial request
+ */
+void obstaclePrintStats() {
+  fsmStatsPrint(&obsStats);
+  watchdogPrint(&obsWatchdog);
+  lineFollowPrintWatchdog();
+  colorVotePrint(&obsVote);
+}
 
-  switch (state) {
+// ============ OBSTACLE COURSE FSM ============
 
-    // ---------------------------------------------------------
-    // STATE: FOLLOW RED LINE
-    // Main driving state with obstacle/blue/black detection
-    // ---------------------------------------------------------
-    case OBS_FOLLOW_RED: {
+/**
+ * Obstacle course task - call from loop() every pass
+ * Turns and pauses are awaited, so the motion and sensing tasks keep running.
+ */
+uint8_t navigateObstacleFSM() {
+  Task* t = &obsTask;
+  TASK_BEGIN(t);
+
+  while (true) {
+    fsmStatsUpdate(&obsStats, state);
+    overBudget = watchdogCheck(&obsWatchdog, state);
+
+    switch (state) {
+
+      // ---------------------------------------------------------
+      // STATE: FOLLOW RED LINE
+      // Main driving state with obstacle/blue/black detection
+      // ---------------------------------------------------------
+      case OBS_FOLLOW_RED: {
+        // One reading per tick serves every check below; zone checks use
+        // the voted color, line correction the raw reading
+        seen = classifyAmong(OBS_FOLLOW_COLORS);
+        colorVoteUpdate(&obsVote, seen, colorLastSampleMs());
+
+        // Priority 1: Check for black (course end)
+        if (colorVoteStable(&obsVote) == COLOR_BLACK) {
+          LOG("[OBS] BLACK detected - course complete!");
+          motorBrake();
+          state = OBS_COMPLETE;
+          break;
+        }
 
-      // Priority 1: Check for black (course end)
-      if (obsIsBlack()) {
-        Serial.println("[OBS] BLACK detected - course complete!");
-        motorStop();
-        state = OBS_COMPLETE;
-        break;
-      }
+        // Priority 2: Check for blue zone (pickup/dropoff) - once per zone
+        if (colorVoteEntered(&obsVote, COLOR_BLUE)) {
+          motorBrake();
+          blueCount++;
+          LOG("[OBS] BLUE zone detected (#%d, %lu ms ago)", blueCount, millis() - colorVoteSince(&obsVote));
+
+          if (blueCount == 1) {
+            state = OBS_PICKUP_BOX;
+          } else {
+            state = OBS_DROPOFF_BOX;
+          }
+          break;
+        }
 
-      // Priority 2: Check for blue zone (pickup/dropoff)
-      if (obsIsBlue()) {
-        motorStop();
-        blueCount++;
-        Serial.print("[OBS] BLUE zone detected (#");
-        Serial.print(blueCount);
-        Serial.println(")");
+        // Priority 3: Check for obstacle
+        if (ultrasonicLastWithin(OBS_DETECT_CM)) {
+          LOG("[OBS] Obstacle detected - starting dodge");
+          motorBrake();
+          state = OBS_DODGE_TURN_RIGHT;
+          break;
+        }
 
-        if (blueCount == 1) {
-          state = OBS_PICKUP_BOX;
-        } else {
-          state = OBS_DROPOFF_BOX;
+        // Use line follow FSM for IR-based line correction
+        lineFollowStep(COLOR_RED, seen);
+        if (lineFollowGetState() == STATE_LF_STOPPED) {
+          LOG("[OBS] Red line lost for good - stopping the course");
+          state = OBS_COMPLETE;
         }
         break;
       }
 
-      // Priority 3: Check for obstacle
-      if (ultrasonicObjectWithin(OBS_DETECT_CM)) {
-        Serial.println("[OBS] Obstacle detected - starting dodge");
-        motorStop();
-        state = OBS_DODGE_TURN_RIGHT;
+      // ---------------------------------------------------------
+      // STATE: PICKUP BOX (scaffolding)
+      // TODO: Implement servo gripper pickup
+      // ---------------------------------------------------------
+      case OBS_PICKUP_BOX: {
+        LOG("[OBS] PICKUP_BOX - TODO: implement pickup");
+
+        // TODO: Close gripper to pick up box
+        // servoSetAngle(GRIPPER_CLOSE_ANGLE);
+        // TASK_AWAIT_MS(t, 500);
+
+        TASK_AWAIT_MS(t, 300);
+
+        // Resume following red line
+        lineFollowReset();
+        state = OBS_FOLLOW_RED;
+        LOG("[OBS] Resuming line follow after pickup zone");
         break;
       }
 
-      // Use line follow FSM for IR-based line correction
-      lineFollowFSM("RED");
-      break;
-    }
-
-    // ---------------------------------------------------------
-    // STATE: PICKUP BOX (scaffolding)
-    // TODO: Implement servo gripper pickup
-    // ---------------------------------------------------------
-    case OBS_PICKUP_BOX: {
-      Serial.println("[OBS] PICKUP_BOX - TODO: implement pickup");
+      // ---------------------------------------------------------
+      // STATE: DROPOFF BOX (scaffolding)
+      // TODO: Implement servo gripper dropoff
+      // ---------------------------------------------------------
+      case OBS_DROPOFF_BOX: {
+        LOG("[OBS] DROPOFF_BOX - TODO: implement dropoff");
 
-      // TODO: Close gripper to pick up box
-      // servoSetAngle(GRIPPER_CLOSE_ANGLE);
-      // delay(500);
+        // TODO: Open gripper to release box
+        // servoSetAngle(GRIPPER_OPEN_ANGLE);
+        // TASK_AWAIT_MS(t, 500);
 
-      delay(300);
+        TASK_AWAIT_MS(t, 300);
 
-      // Resume following red line
-      state = OBS_FOLLOW_RED;
-      Serial.println("[OBS] Resuming line follow after pickup zone");
-      break;
-    }
+        // Resume following red line
+        lineFollowReset();
+        state = OBS_FOLLOW_RED;
+        LOG("[OBS] Resuming line follow after dropoff zone");
+        break;
+      }
 
-    // ---------------------------------------------------------
-    // STATE: DROPOFF BOX (scaffolding)
-    // TODO: Implement servo gripper dropoff
-    // ---------------------------------------------------------
-    case OBS_DROPOFF_BOX: {
-      Serial.println("[OBS] DROPOFF_BOX - TODO: implement dropoff");
+      // ---------------------------------------------------------
+      // STATE: DODGE - Turn right 90° away from obstacle
+      // ---------------------------------------------------------
+      case OBS_DODGE_TURN_RIGHT: {
+        LOG("[OBS] Dodge: turning right 90 degrees");
+        TASK_AWAIT_UNTIL(t, motorIdle());  // Let the brake finish
+        motorTurnRight(OBS_TURN_SPEED, motorTurnTime(OBS_TURN_SPEED, -90, OBS_TURN_90_TIME));
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        motorStop();
+        TASK_AWAIT_MS(t, 100);
 
-      // TODO: Open gripper to release box
-      // servoSetAngle(GRIPPER_OPEN_ANGLE);
-      // delay(500);
+        // Start timer for driving past obstacle width
+        dodgeTimer = millis();
+        state = OBS_DODGE_PASS_SIDE;
+        break;
+      }
 
-      delay(300);
+      // ---------------------------------------------------------
+      // STATE: DODGE - Drive forward to clear obstacle width
+      // ---------------------------------------------------------
+      case OBS_DODGE_PASS_SIDE: {
+        motorMoveForward(OBS_DODGE_SPEED);
+
+        if (millis() - dodgeTimer >= DODGE_SIDE_TIME) {
+          motorBrake();
+          TASK_AWAIT_MS(t, 100);
+          LOG("[OBS] Dodge: cleared obstacle width");
+          state = OBS_DODGE_TURN_FORWARD;
+        }
+        break;
+      }
 
-      // Resume following red line
-      state = OBS_FOLLOW_RED;
-      Serial.println("[OBS] Resuming line follow after dropoff zone");
-      break;
-    }
+      // ---------------------------------------------------------
+      // STATE: DODGE - Turn left 90° to face parallel to line
+      // ---------------------------------------------------------
+      case OBS_DODGE_TURN_FORWARD: {
+        LOG("[OBS] Dodge: turning left 90 degrees (parallel)");
+        motorTurnLeft(OBS_TURN_SPEED, motorTurnTime(OBS_TURN_SPEED, 90, OBS_TURN_90_TIME));
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        motorStop();
+        TASK_AWAIT_MS(t, 100);
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Turn right 90° away from obstacle
-    // ---------------------------------------------------------
-    case OBS_DODGE_TURN_RIGHT: {
-      Serial.println("[OBS] Dodge: turning right 90 degrees");
-      motorTurnRight(OBS_TURN_SPEED, OBS_TURN_90_TIME);
-      motorStop();
-      delay(100);
-
-      // Start timer for driving past obstacle width
-      dodgeTimer = millis();
-      state = OBS_DODGE_PASS_SIDE;
-      break;
-    }
+        // Start timer for driving past obstacle length
+        dodgeTimer = millis();
+        state = OBS_DODGE_PASS_LENGTH;
+        break;
+      }
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Drive forward to clear obstacle width
-    // ---------------------------------------------------------
-    case OBS_DODGE_PASS_SIDE: {
-      motorMoveForward(OBS_DODGE_SPEED);
+      // ---------------------------------------------------------
+      // STATE: DODGE - Drive forward to clear obstacle length
+      // ---------------------------------------------------------
+      case OBS_DODGE_PASS_LENGTH: {
+        motorMoveForward(OBS_DODGE_SPEED);
+
+        if (millis() - dodgeTimer >= DODGE_LENGTH_TIME) {
+          motorBrake();
+          TASK_AWAIT_MS(t, 100);
+          LOG("[OBS] Dodge: cleared obstacle length");
+          state = OBS_DODGE_TURN_TO_LINE;
+        }
+        break;
+      }
 
-      if (millis() - dodgeTimer >= DODGE_SIDE_TIME) {
+      // ---------------------------------------------------------
+      // STATE: DODGE - Turn left 90° to face toward the line
+      // ---------------------------------------------------------
+      case OBS_DODGE_TURN_TO_LINE: {
+        LOG("[OBS] Dodge: turning left 90 degrees (toward line)");
+        motorTurnLeft(OBS_TURN_SPEED, motorTurnTime(OBS_TURN_SPEED, 90, OBS_TURN_90_TIME));
+        TASK_AWAIT_UNTIL(t, motorIdle());
         motorStop();
-        delay(100);
-        Serial.println("[OBS] Dodge: cleared obstacle width");
-        state = OBS_DODGE_TURN_FORWARD;
+        TASK_AWAIT_MS(t, 100);
+
+        findRedRecoveries = 0;
+        findRedBackward = false;
+        findRedAlignDeg = 90;
+        state = OBS_DODGE_FIND_RED;
+        LOG("[OBS] Dodge: searching for red line");
+        break;
       }
-      break;
-    }
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Turn left 90° to face parallel to line
-    // ---------------------------------------------------------
-    case OBS_DODGE_TURN_FORWARD: {
-      Serial.println("[OBS] Dodge: turning left 90 degrees (parallel)");
-      motorTurnLeft(OBS_TURN_SPEED, OBS_TURN_90_TIME);
-      motorStop();
-      delay(100);
-
-      // Start timer for driving past obstacle length
-      dodgeTimer = millis();
-      state = OBS_DODGE_PASS_LENGTH;
-      break;
-    }
+      // ---------------------------------------------------------
+      // STATE: DODGE - Drive forward until red line is found
+      // On a watchdog overrun: reverse (the line may have slipped
+      // between reads), then widen toward the course, then realign
+      // and hand over to the line follower's line-lost search.
+      // ---------------------------------------------------------
+      case OBS_DODGE_FIND_RED: {
+        if (overBudget) {
+          motorBrake();
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          findRedRecoveries++;
+          if (findRedRecoveries == 1) {
+            LOG("[OBS] Dodge: no red ahead - reversing to re-acquire");
+            findRedBackward = true;
+          } else if (findRedRecoveries == 2) {
+            LOG("[OBS] Dodge: widening search %d degrees toward the course", OBS_FIND_RED_WIDEN_DEG);
+            findRedBackward = false;
+            motorTurnRight(OBS_TURN_SPEED, motorTurnTime(OBS_TURN_SPEED, -OBS_FIND_RED_WIDEN_DEG, OBS_TURN_90_TIME));
+            TASK_AWAIT_UNTIL(t, motorIdle());
+            findRedAlignDeg = 90 - OBS_FIND_RED_WIDEN_DEG;
+          } else {
+            LOG("[OBS] Dodge: red not found - realigning and searching with line follow");
+            state = OBS_DODGE_ALIGN;
+            break;
+          }
+          watchdogRestart(&obsWatchdog);  // The new attempt gets a full budget
+        }
+
+        if (findRedBackward) {
+          motorMoveBackward(OBS_SEARCH_SPEED);
+        } else {
+          motorMoveForward(OBS_SEARCH_SPEED);
+        }
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Drive forward to clear obstacle length
-    // ---------------------------------------------------------
-    case OBS_DODGE_PASS_LENGTH: {
-      motorMoveForward(OBS_DODGE_SPEED);
+        if (obsIsRed()) {
+          motorBrake();
+          TASK_AWAIT_MS(t, 100);
+          LOG("[OBS] Dodge: red line found!");
+          state = OBS_DODGE_ALIGN;
+        }
 
-      if (millis() - dodgeTimer >= DODGE_LENGTH_TIME) {
-        motorStop();
-        delay(100);
-        Serial.println("[OBS] Dodge: cleared obstacle length");
-        state = OBS_DODGE_TURN_TO_LINE;
+        TASK_AWAIT_MS(t, OBS_SENSOR_DELAY);
+        break;
       }
-      break;
-    }
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Turn left 90° to face toward the line
-    // ---------------------------------------------------------
-    case OBS_DODGE_TURN_TO_LINE: {
-      Serial.println("[OBS] Dodge: turning left 90 degrees (toward line)");
-      motorTurnLeft(OBS_TURN_SPEED, OBS_TURN_90_TIME);
-      motorStop();
-      delay(100);
-
-      state = OBS_DODGE_FIND_RED;
-      Serial.println("[OBS] Dodge: searching for red line");
-      break;
-    }
+      // ---------------------------------------------------------
+      // STATE: DODGE - Turn right 90° to realign with line
+      // ---------------------------------------------------------
+      case OBS_DODGE_ALIGN: {
+        LOG("[OBS] Dodge: turning right %d degrees (realign)", findRedAlignDeg);
+        motorTurnRight(OBS_TURN_SPEED, motorTurnTime(OBS_TURN_SPEED, -findRedAlignDeg, OBS_TURN_90_TIME));
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        motorStop();
+        TASK_AWAIT_MS(t, 100);
 
-    // ---------------------------------------------------------
-    // STATE: DODGE - Drive forward until red line is found
-    // ---------------------------------------------------------
-    case OBS_DODGE_FIND_RED: {
-      motorMoveForward(OBS_SEARCH_SPEED);
+        if (findRedRecoveries > 2) {
+          // The dodge went right of the line, so it is to the left now
+          lineFollowSearch(LINE_SIDE_LEFT);
+        } else {
+          lineFollowReset();
+        }
+        LOG("[OBS] Dodge complete - resuming line follow");
+        state = OBS_FOLLOW_RED;
+        break;
+      }
 
-      if (obsIsRed()) {
+      // ---------------------------------------------------------
+      // STATE: COMPLETE - Course finished
+      // ---------------------------------------------------------
+      case OBS_COMPLETE: {
         motorStop();
-        delay(100);
-        Serial.println("[OBS] Dodge: red line found!");
-        state = OBS_DODGE_ALIGN;
+        LOG("[OBS] === OBSTACLE COURSE COMPLETE ===");
+        fsmStatsPrintOnce(&obsStats);
+        flightRecorderDumpFinal();
+        break;
       }
 
-      delay(OBS_SENSOR_DELAY);
-      break;
-    }
-
-    // ---------------------------------------------------------
-    // STATE: DODGE - Turn right 90° to realign with line
-    // ---------------------------------------------------------
-    case OBS_DODGE_ALIGN: {
-      Serial.println("[OBS] Dodge: turning right 90 degrees (realign)");
-      motorTurnRight(OBS_TURN_SPEED, OBS_TURN_90_TIME);
-      motorStop();
-      delay(100);
-
-      Serial.println("[OBS] Dodge complete - resuming line follow");
-      state = OBS_FOLLOW_RED;
-      break;
-    }
-
-    // ---------------------------------------------------------
-    // STATE: COMPLETE - Course finished
-    // ---------------------------------------------------------
-    case OBS_COMPLETE: {
-      motorStop();
-      Serial.println("[OBS] === OBSTACLE COURSE COMPLETE ===");
-      return;
+      // ---------------------------------------------------------
+      // Default safety
+      // ---------------------------------------------------------
+      default:
+        LOG("[OBS] ERROR: Unknown state");
+        motorStop();
+        flightRecorderDumpFinal();
+        state = OBS_COMPLETE;
+        break;
     }
 
-    // ---------------------------------------------------------
-    // Default safety
-    // ---------------------------------------------------------
-    default:
-      Serial.println("[OBS] ERROR: Unknown state");
-      motorStop();
-      state = OBS_COMPLETE;
-      break;
+    // Record this tick and let the other tasks run
+    flightRecorderTick(state);
+    TASK_YIELD(t);
   }
+
+  TASK_END(t);
 }
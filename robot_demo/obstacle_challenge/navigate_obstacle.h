@@ -13,7 +13,7 @@
 #define OBS_SEARCH_SPEED   100  // Speed while searching for red line
 
 // Turn timing (calibrate to your robot)
-#define OBS_TURN_90_TIME   500  // ms for a 90-degree turn
+#define OBS_TURN_90_TIME   500  // ms for a 90-degree turn (until turn-calibrated)
 
 // Obstacle detection
 #define OBS_DETECT_CM      15.0  // Distance threshold to trigger dodge (cm)
@@ -25,6 +25,16 @@
 // Sensor timing
 #define OBS_SENSOR_DELAY   30    // ms between sensor checks in follow state
 
+// State watchdog: the line search after a dodge is the one open-ended state.
+// Each overrun escalates: reverse to re-acquire, widen toward the course,
+// then realign and run the line follower's line-lost search.
+#define OBS_FIND_RED_BUDGET_MS    2500  // Search time per attempt
+#define OBS_FIND_RED_BUDGET_TICKS 120   // ... or sensor checks, whichever first
+#define OBS_FIND_RED_WIDEN_DEG    30    // Turn toward the course direction to widen
+
+// FSM stats: distinct transitions counted (the FSM makes about 18)
+#define OBS_STATS_TRANSITIONS     24
+
 // ============ FSM STATES ============
 enum ObstacleState {
   OBS_FOLLOW_RED,          // Following red line, checking for obstacles/blue/black
@@ -45,8 +55,14 @@ enum ObstacleState {
 // Call once in setup() before entering the obstacle course
 void obstacleSetup();
 
-// Call repeatedly in loop() to run the FSM
-void navigateObstacleFSM();
+// Call every pass of loop() to run the FSM task (never blocks)
+uint8_t navigateObstacleFSM();
+
+// Current FSM state (for recording)
+ObstacleState obstacleGetState();
+
+// Print per-state dwell/transition stats and watchdog trips (also printed once on completion)
+void obstaclePrintStats();
 
 // Color helpers
 bool obsIsRed();
@@ -5,24 +5,35 @@
 #include "ultrasonic_sensor_func.h"
 #include "line_follow_func.h"
 #include "navigate_obstacle.h"
+#include "fsm_stats.h"
+#include "flight_recorder.h"
+#include "telemetry.h"
+#include "log_sink.h"
+#include "odometry.h"
+#include "turn_cal.h"
+#include "task.h"
+
+static Task rangingTask;    // Background ultrasonic measurements
+static Task telemetryLoop;  // Binary telemetry frames
+static Task logLoop;        // Log drain and periodic drop report
+static Task odometryLoop;   // Pose integration
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(TELEMETRY_BAUD);
   delay(200);
 
-  Serial.println("\n=== OBSTACLE CHALLENGE STARTED ===");
+  Serial.println(F("\n=== OBSTACLE CHALLENGE STARTED ==="));
 
-  // Initialize color sensor
-  pinMode(PIN_S0, OUTPUT);
-  pinMode(PIN_S1, OUTPUT);
-  pinMode(PIN_S2, OUTPUT);
-  pinMode(PIN_S3, OUTPUT);
-  pinMode(PIN_OUT, INPUT);
-  digitalWrite(PIN_S0, HIGH);
-  digitalWrite(PIN_S1, LOW);
+  // Initialize color sensor (pins, frequency scaling)
+  colorSensorSetup();
 
-  Serial.print("Color sensor initialized. Black threshold: ");
+  Serial.print(F("Color sensor initialized. Black threshold: "));
   Serial.println(BLACK_THRESHOLD);
+  if (colorCalibrationLoad()) {
+    Serial.println(F("Color calibration loaded from EEPROM"));
+  } else {
+    Serial.println(F("No color calibration - using black threshold (send 'c' to calibrate)"));
+  }
 
   // Initialize motors
   motorSetup();
@@ -33,15 +44,66 @@ void setup() {
   // Initialize IR sensors for line following
   pinMode(IR_LEFT_PIN, INPUT);
   pinMode(IR_RIGHT_PIN, INPUT);
-  Serial.println("IR sensors initialized");
+  Serial.println(F("IR sensors initialized"));
 
   // Initialize obstacle course FSM
   obstacleSetup();
 
-  Serial.println("=== STARTING OBSTACLE COURSE ===\n");
+  Serial.println(F("=== STARTING OBSTACLE COURSE ===\n"));
   delay(500);
 }
 
 void loop() {
-  navigateObstacleFSM();
+  // Check for serial commands
+  if (Serial.available() > 0) {
+    handleCommand(Serial.read());
+  }
+
+  // Cooperative tasks - none of these block
+  motorTask();
+  odometryTask(&odometryLoop);
+  ultrasonicTask(&rangingTask);
+  if (turnCalActive()) {
+    turnCalTask();  // Owns the motors until done
+  } else {
+    navigateObstacleFSM();
+  }
+  telemetryTask(&telemetryLoop);
+  logSinkTask(&logLoop);
+}
+
+void handleCommand(char cmd) {
+  switch (cmd) {
+    case FSM_STATS_CMD:
+      obstaclePrintStats();
+      break;
+
+    case FR_DUMP_CMD:
+      flightRecorderDump();
+      break;
+
+    case TELEMETRY_CMD:
+      telemetrySetEnabled(!telemetryEnabled());
+      break;
+
+    case LOG_STATS_CMD:
+      logReport();
+      break;
+
+    case COLOR_CAL_CMD:
+      colorCalibrationCommand();
+      break;
+
+    case ODO_CMD:
+      odometryPrint();
+      break;
+
+    case TURN_CAL_CMD:
+      turnCalCommand();
+      break;
+
+    case WHEEL_CAL_CMD:
+      wheelCalCommand();
+      break;
+  }
 }
@@ -0,0 +1,57 @@
+/* Dead-reckoning odometry: (x, y, heading) and covariance from commanded wheel PWM. */
+#ifndef ODOMETRY_H
+#define ODOMETRY_H
+
+#include "Arduino.h"
+#include "task.h"
+
+// ============ ODOMETRY CONFIGURATION ============
+// Wheel speed model: 0 below the deadband, then linear in PWM. Measure by
+// timing a straight run at two PWM values and fitting the line. Commands
+// are the requested speeds: a wheel calibration maps them to per-wheel
+// PWMs that make both wheels match this one model.
+#define ODO_DEADBAND_PWM   60     // PWM below which a wheel does not turn
+#define ODO_MM_PER_S_PWM   1.6    // Wheel speed per PWM step above the deadband (mm/s)
+#define ODO_TRACK_MM       130    // Distance between the wheel contact points
+#define ODO_TICK_MS        20     // Integration period
+#define ODO_SLIP_MM2_PER_MM 0.05  // Wheel travel variance (mm^2) per mm driven
+#define ODO_CMD            'o'    // Serial command: print pose and uncertainty
+
+// ============ POSE ============
+// Origin and heading 0 are wherever odometryReset() put them; theta is CCW.
+struct OdoPose {
+  float x;      // mm
+  float y;      // mm
+  float theta;  // radians
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Set a known pose with zero uncertainty (start, or a landmark with known heading)
+void odometryReset(float x, float y, float theta);
+
+// Position fix at a landmark (e.g. a color boundary); heading is kept.
+// sigmaMm is how well the landmark pins the position.
+void odometryAnchor(float x, float y, float sigmaMm);
+
+// Wheel command from motor_func (signed speed as requested, before the wheel table)
+void odometrySetWheels(int left, int right);
+
+// Odometry task - call from loop() every pass; integrates every ODO_TICK_MS
+uint8_t odometryTask(Task* t);
+
+// Current pose and 1-sigma uncertainty
+OdoPose odometryPose();
+float odometryPositionSigma();  // mm, larger axis of x / y
+float odometryHeadingSigma();   // radians
+
+// Path length driven since power-up (mm); odometryReset() does not clear it
+float odometryDistance();
+
+// Modelled wheel speed (mm/s) for a signed PWM
+float odometryWheelSpeed(int pwm);
+
+// Print pose and uncertainty
+void odometryPrint();
+
+#endif  // ODOMETRY_H
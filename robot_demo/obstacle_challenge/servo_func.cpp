@@ -1,5 +1,6 @@
 /* Servo: position, center, sweep. Used for gripper. */
 #include "servo_func.h"
+#include "log_sink.h"
 
 // Servo object
 Servo servo;
@@ -7,6 +8,9 @@ Servo servo;
 // Track current angle
 int currentAngle = SERVO_CENTER;
 
+// Angle of the sweep task in progress
+static int sweepAngle = SERVO_CENTER;
+
 // ============ SETUP ============
 
 /**
@@ -16,7 +20,8 @@ int currentAngle = SERVO_CENTER;
 void servoSetup() {
   servo.attach(SERVO_PIN);
   servoCenter();
-  Serial.println("[SERVO] Servo initialized on pin " + String(SERVO_PIN));
+  Serial.print(F("[SERVO] Servo initialized on pin "));
+  Serial.println(SERVO_PIN);
 }
 
 // ============ POSITION CONTROL ============
@@ -32,8 +37,7 @@ void servoSetAngle(int angle) {
   servo.write(angle);
   currentAngle = angle;
 
-  Serial.print("[SERVO] Set angle: ");
-  Serial.println(angle);
+  LOG("[SERVO] Set angle: %d", angle);
 }
 
 /**
@@ -65,10 +69,7 @@ void servoSweep(int startAngle, int endAngle, int stepDelay) {
   startAngle = constrain(startAngle, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
   endAngle = constrain(endAngle, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
 
-  Serial.print("[SERVO] Sweep from ");
-  Serial.print(startAngle);
-  Serial.print(" to ");
-  Serial.println(endAngle);
+  LOG("[SERVO] Sweep from %d to %d", startAngle, endAngle);
 
   if (startAngle < endAngle) {
     for (int angle = startAngle; angle <= endAngle; angle++) {
@@ -84,3 +85,30 @@ void servoSweep(int startAngle, int endAngle, int stepDelay) {
 
   currentAngle = endAngle;
 }
+
+/**
+ * Gradually sweep servo between two angles without blocking
+ * Pass the same arguments on every call until it returns TASK_DONE
+ *
+ * @param startAngle Starting angle in degrees (0-180)
+ * @param endAngle   Ending angle in degrees (0-180)
+ * @param stepDelay  Delay in ms between each 1-degree step
+ */
+uint8_t servoSweepTask(Task* t, int startAngle, int endAngle, int stepDelay) {
+  // Clamp on every call - arguments are passed again after each resume
+  startAngle = constrain(startAngle, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
+  endAngle = constrain(endAngle, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
+
+  TASK_BEGIN(t);
+
+  LOG("[SERVO] Sweep task from %d to %d", startAngle, endAngle);
+
+  for (sweepAngle = startAngle; sweepAngle != endAngle; sweepAngle += (endAngle > startAngle) ? 1 : -1) {
+    servo.write(sweepAngle);
+    TASK_AWAIT_MS(t, stepDelay);
+  }
+  servo.write(endAngle);
+
+  currentAngle = endAngle;
+  TASK_END(t);
+}
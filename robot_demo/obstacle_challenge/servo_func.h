@@ -4,6 +4,7 @@
 
 #include "Arduino.h"
 #include <Servo.h>
+#include "task.h"
 
 // ============ SERVO CONFIGURATION ============
 #define SERVO_PIN 18        // PWM pin connected to servo signal
@@ -25,4 +26,7 @@ void servoCenter();
 // Sweep (blocking - moves gradually between two angles)
 void servoSweep(int startAngle, int endAngle, int stepDelay = SERVO_SWEEP_DELAY);
 
+// Sweep as a task (non-blocking) - run with TASK_AWAIT_TASK until TASK_DONE
+uint8_t servoSweepTask(Task* t, int startAngle, int endAngle, int stepDelay = SERVO_SWEEP_DELAY);
+
 #endif  // SERVO_FUNC_H
@@ -0,0 +1,94 @@
+/* State watchdog: trips when a state outlives its budget, so the FSM can recover. */
+#include "state_watchdog.h"
+#include "log_sink.h"
+
+// ============ WATCHDOG ============
+
+static StateBudget budgetOf(const StateWatchdog* wd, uint8_t state) {
+  StateBudget budget;
+#if defined(__AVR__)
+  memcpy_P(&budget, &wd->budgets[state], sizeof(budget));
+#else
+  budget = wd->budgets[state];
+#endif
+  return budget;
+}
+
+/**
+ * Reset all counters and start timing the initial state
+ */
+void watchdogBegin(StateWatchdog* wd, const char* tag, const StateName* names,
+                   const StateBudget* budgets, uint8_t numStates, uint8_t initialState) {
+  memset(wd, 0, sizeof(StateWatchdog));
+  wd->tag = tag;
+  wd->names = names;
+  wd->budgets = budgets;
+  wd->numStates = min(numStates, (uint8_t)WATCHDOG_MAX_STATES);
+  wd->current = initialState;
+  wd->enteredAt = millis();
+}
+
+/**
+ * Count one tick in `state`; a new state starts a fresh budget
+ * @return true when the state has overrun its time or tick budget
+ */
+bool watchdogCheck(StateWatchdog* wd, uint8_t state) {
+  if (state >= wd->numStates) {
+    return false;
+  }
+  if (state != wd->current) {
+    wd->current = state;
+    watchdogRestart(wd);
+  }
+  if (wd->ticks < 65535) {
+    wd->ticks++;
+  }
+
+  StateBudget budget = budgetOf(wd, state);
+  unsigned long elapsed = millis() - wd->enteredAt;
+  if ((budget.maxMs == 0 || elapsed <= budget.maxMs) &&
+      (budget.maxTicks == 0 || wd->ticks <= budget.maxTicks)) {
+    return false;
+  }
+
+  if (wd->trips[state] < 255) {
+    wd->trips[state]++;
+  }
+  LOG("[%s] WATCHDOG: " LOG_FSTR " over budget (%lu ms, %u ticks) - recovery %u",
+      wd->tag, wd->names[state], elapsed, wd->ticks, wd->trips[state]);
+  watchdogRestart(wd);
+  return true;
+}
+
+void watchdogRestart(StateWatchdog* wd) {
+  wd->enteredAt = millis();
+  wd->ticks = 0;
+}
+
+uint8_t watchdogTrips(const StateWatchdog* wd, uint8_t state) {
+  return state < wd->numStates ? wd->trips[state] : 0;
+}
+
+/**
+ * Print overrun counts of the states that tripped
+ */
+void watchdogPrint(const StateWatchdog* wd) {
+  Serial.print('[');
+  Serial.print(wd->tag);
+  Serial.print(F("] Watchdog trips:"));
+  bool any = false;
+  for (uint8_t s = 0; s < wd->numStates; s++) {
+    if (wd->trips[s] == 0) {
+      continue;
+    }
+    Serial.print(' ');
+    Serial.print(FLASH_STR(wd->names[s]));
+    Serial.print(F(" x"));
+    Serial.print(wd->trips[s]);
+    any = true;
+  }
+  if (!any) {
+    Serial.print(F(" none"));
+  }
+  Serial.println();
+}
@@ -0,0 +1,56 @@
+/* State watchdog: per-state time and tick budgets that bound how long an FSM can stay stuck. */
+#ifndef STATE_WATCHDOG_H
+#define STATE_WATCHDOG_H
+
+#include "Arduino.h"
+
+// ============ STATE WATCHDOG CONFIGURATION ============
+#define WATCHDOG_MAX_STATES 18  // Largest challenge FSM (NavigationState) has 18 states
+
+// Budget for one visit to a state; 0 = no limit. Whichever runs out first trips.
+struct StateBudget {
+  uint16_t maxMs;     // Time in the state
+  uint16_t maxTicks;  // FSM ticks in the state
+};
+
+// ============ STATE NAMES ============
+// FSM state names, one fixed-width row per state, kept in flash:
+//   static const StateName NAMES[] PROGMEM = { "FORWARD", ... };
+#define STATE_NAME_SIZE 22  // Longest name (GREEN_FOUND_FIRST_RED) + 1
+typedef char StateName[STATE_NAME_SIZE];
+
+// ============ STATE WATCHDOG RECORD ============
+// One instance per FSM. The FSM owns the recovery: the watchdog only says
+// when a state has overrun, and logs it.
+struct StateWatchdog {
+  const char* tag;                   // Log prefix, e.g. "OBS"
+  const StateName* names;            // State names in flash, indexed by state value
+  const StateBudget* budgets;        // In flash (PROGMEM), indexed by state value
+  uint8_t numStates;
+  uint8_t current;                   // State being timed
+  unsigned long enteredAt;           // millis() the budget started
+  uint16_t ticks;                    // Ticks since then
+  uint8_t trips[WATCHDOG_MAX_STATES];  // Overruns per state (saturate at 255)
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Reset and start timing the given initial state
+void watchdogBegin(StateWatchdog* wd, const char* tag, const StateName* names,
+                   const StateBudget* budgets, uint8_t numStates, uint8_t initialState);
+
+// Call once per FSM tick with the current state. True (and logged) when the
+// state has used up its budget; the budget then restarts, so a state that
+// stays stuck trips again.
+bool watchdogCheck(StateWatchdog* wd, uint8_t state);
+
+// Restart the current state's budget (progress made, or FSM resumed after a pause)
+void watchdogRestart(StateWatchdog* wd);
+
+// Overruns of a state this run
+uint8_t watchdogTrips(const StateWatchdog* wd, uint8_t state);
+
+// Print the states that have tripped
+void watchdogPrint(const StateWatchdog* wd);
+
+#endif  // STATE_WATCHDOG_H
@@ -0,0 +1,62 @@
+/* Cooperative stackless tasks (protothread style) with millisecond waits. */
+#ifndef TASK_H
+#define TASK_H
+
+#include "Arduino.h"
+
+// ============ TASK MODEL ============
+// A task is a function `uint8_t myTask(Task* t)` called from loop() every pass.
+// TASK_AWAIT_* return to loop() and resume at the same line on a later call,
+// so long maneuvers read linearly without blocking other tasks.
+//
+// Rules:
+// - Local variables do NOT survive a wait or yield: keep state in statics.
+// - Do not declare initialized locals between TASK_BEGIN and a wait in the
+//   same scope (the resume jump would skip their initialization).
+// - Uses GCC label addresses, so waits also work inside switch statements.
+
+#define TASK_RUNNING 0  // Task yielded and wants to be called again
+#define TASK_DONE    1  // Task ran to TASK_END
+
+struct Task {
+  void* resume;          // Label to continue from (NULL = start of task)
+  unsigned long wakeAt;  // Deadline for TASK_AWAIT_MS
+};
+
+#define TASK_CONCAT2(a, b) a##b
+#define TASK_CONCAT(a, b)  TASK_CONCAT2(a, b)
+#define TASK_LABEL         TASK_CONCAT(taskResume, __LINE__)
+
+// Restart a task from its first line on the next call
+inline void taskReset(Task* t) {
+  t->resume = NULL;
+}
+
+// ============ TASK MACROS ============
+
+// First statement of a task body
+#define TASK_BEGIN(t) \
+  do { if ((t)->resume) goto *(t)->resume; } while (0)
+
+// Last statement of a task body
+#define TASK_END(t) \
+  do { (t)->resume = NULL; return TASK_DONE; } while (0)
+
+// Give up the CPU for one pass of loop()
+#define TASK_YIELD(t) \
+  do { (t)->resume = &&TASK_LABEL; return TASK_RUNNING; TASK_LABEL:; } while (0)
+
+// Wait until cond is true (re-evaluated on every call)
+#define TASK_AWAIT_UNTIL(t, cond) \
+  do { (t)->resume = &&TASK_LABEL; TASK_LABEL: if (!(cond)) return TASK_RUNNING; } while (0)
+
+// Wait for ms milliseconds without blocking other tasks
+#define TASK_AWAIT_MS(t, ms) \
+  do { (t)->wakeAt = millis() + (ms); \
+       TASK_AWAIT_UNTIL(t, (long)(millis() - (t)->wakeAt) >= 0); } while (0)
+
+// Run a child task to completion (child is restarted first)
+#define TASK_AWAIT_TASK(t, child, call) \
+  do { taskReset(child); TASK_AWAIT_UNTIL(t, (call) == TASK_DONE); } while (0)
+
+#endif  // TASK_H
@@ -1,5 +1,9 @@
 /* HC-SR04: distance in cm. Trigger/echo timing. */
 #include "ultrasonic_sensor_func.h"
+#include "flight_recorder.h"
+
+// Latest background measurement (0.0 until the first one)
+static float lastDistanceCm = 0.0;
 
 // ============ SETUP ============
 
@@ -11,13 +15,13 @@ void ultrasonicSetup() {
   pinMode(US_ECHO_PIN, INPUT);
   digitalWrite(US_TRIGGER_PIN, LOW);
 
-  Serial.println("[US] Ultrasonic sensor initialized");
-  Serial.print("[US] Trigger pin: A0, Echo pin: A1");
-  Serial.print(" | Range: ");
+  Serial.println(F("[US] Ultrasonic sensor initialized"));
+  Serial.print(F("[US] Trigger pin: A0, Echo pin: A1"));
+  Serial.print(F(" | Range: "));
   Serial.print(US_MIN_RANGE, 1);
-  Serial.print("-");
+  Serial.print(F("-"));
   Serial.print(US_MAX_RANGE, 1);
-  Serial.println(" cm");
+  Serial.println(F(" cm"));
 }
 
 // ============ DISTANCE MEASUREMENT ============
@@ -43,6 +47,7 @@ float ultrasonicGetDistance() {
   // Sound travels at ~343 m/s -> 29.1 us per cm
   // Divide by 2 because signal travels to object and back
   float distanceCm = (duration / 2.0) / 29.1;
+  flightLive.distanceMm = (uint16_t)min(distanceCm * 10.0, 65535.0);
 
   return distanceCm;
 }
@@ -67,3 +72,37 @@ bool ultrasonicObjectWithin(float thresholdCm) {
   float distance = ultrasonicGetDistance();
   return (ultrasonicIsValid(distance) && distance <= thresholdCm);
 }
+
+// ============ BACKGROUND RANGING ============
+
+/**
+ * Measure every US_POLL_INTERVAL ms so the FSM reads a cached distance
+ * instead of waiting on the echo itself
+ */
+uint8_t ultrasonicTask(Task* t) {
+  TASK_BEGIN(t);
+
+  while (true) {
+    lastDistanceCm = ultrasonicGetDistance();
+    TASK_AWAIT_MS(t, US_POLL_INTERVAL);
+  }
+
+  TASK_END(t);
+}
+
+/**
+ * Most recent background measurement in cm
+ */
+float ultrasonicLastDistance() {
+  return lastDistanceCm;
+}
+
+/**
+ * Check the most recent background measurement against a threshold
+ *
+ * @param thresholdCm Distance threshold in centimeters
+ * @return true if a valid object was detected closer than threshold
+ */
+bool ultrasonicLastWithin(float thresholdCm) {
+  return (ultrasonicIsValid(lastDistanceCm) && lastDistanceCm <= thresholdCm);
+}
@@ -3,6 +3,7 @@
 #define ULTRASONIC_SENSOR_FUNC_H
 
 #include "Arduino.h"
+#include "task.h"
 
 // ============ ULTRASONIC SENSOR CONFIGURATION ============
 // HC-SR04 wired to analog pins (used as digital GPIO)
@@ -12,6 +13,7 @@
 #define US_TIMEOUT 30000    // pulseIn timeout in microseconds (~5m max)
 #define US_MAX_RANGE 400.0  // Maximum valid range in cm
 #define US_MIN_RANGE 2.0    // Minimum valid range in cm
+#define US_POLL_INTERVAL 60 // ms between background measurements (HC-SR04 cycle)
 
 // ============ FUNCTION PROTOTYPES ============
 
@@ -23,4 +25,9 @@ float ultrasonicGetDistance();
 bool  ultrasonicIsValid(float distanceCm);
 bool  ultrasonicObjectWithin(float thresholdCm);
 
+// Background ranging task - call from loop() every pass
+uint8_t ultrasonicTask(Task* t);
+float ultrasonicLastDistance();
+bool  ultrasonicLastWithin(float thresholdCm);
+
 #endif  // ULTRASONIC_SENSOR_FUNC_H
@@ -0,0 +1,140 @@
+/* Color class lookup table - generated by tools/gen_color_lut.py, do not edit. */
+// Source: threshold rule, BLACK_THRESHOLD 125 us
+// Cells: BLACK 216, RED 1405, GREEN 1290, BLUE 1185
+#ifndef COLOR_LUT_H
+#define COLOR_LUT_H
+
+#define COLOR_LUT_BINS 16  // Per axis; index = R << 8 | G << 4 | B, two cells per byte
+
+static const uint8_t COLOR_LUT[2048] PROGMEM = {
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x22, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22,
+  0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22, 0x44, 0x44, 0x44, 0x44, 0x24, 0x22, 0x22, 0x22,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x33, 0x33, 0x33, 0x33, 0x44, 0x44, 0x44, 0x44, 0x34, 0x33, 0x33, 0x33,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+  0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11,
+};
+
+#endif  // COLOR_LUT_H
@@ -0,0 +1,133 @@
+/* Temporal voting filter on color class: k-of-n entry, sticky exit, timestamped boundaries. */
+#include "color_vote.h"
+#include "log_sink.h"
+
+/**
+ * Clear the ring and start from UNKNOWN
+ * @param rules Per-color {enter, leave}, COLOR_CLASS_COUNT entries
+ */
+void colorVoteBegin(ColorVote* vote, const ColorVoteRule* rules) {
+  memset(vote, 0, sizeof(*vote));
+  vote->rules = rules;
+  vote->stable = COLOR_UNKNOWN;
+  vote->previous = COLOR_UNKNOWN;
+  vote->since = millis();
+}
+
+/**
+ * Add one reading and re-run the vote
+ * The stable color is left only after `leave` of the last VOTE_WINDOW
+ * readings disagree with it, and only for a color that has its own
+ * `enter` votes (most votes wins). The change is dated to the boundary
+ * in front of the new color's latest run.
+ */
+bool colorVoteUpdate(ColorVote* vote, ColorClass reading, unsigned long sampleMs) {
+  unsigned long now = millis();
+  vote->votes[vote->head] = reading;
+  vote->votedAt[vote->head] = sampleMs;
+  vote->head = (vote->head + 1) % VOTE_WINDOW;
+  if (vote->filled < VOTE_WINDOW) {
+    vote->filled++;
+  }
+  vote->changed = false;
+
+  uint8_t count[COLOR_CLASS_COUNT] = { 0 };
+  for (uint8_t i = 0; i < vote->filled; i++) {
+    count[vote->votes[i]]++;
+  }
+
+  // Sticky: stay until enough readings disagree
+  if (vote->stable != COLOR_UNKNOWN &&
+      vote->filled - count[vote->stable] < vote->rules[vote->stable].leave) {
+    return false;
+  }
+
+  ColorClass best = COLOR_UNKNOWN;
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    uint8_t enter = vote->rules[c].enter;
+    if (c == vote->stable || enter == 0 || count[c] < enter) {
+      continue;
+    }
+    if (best == COLOR_UNKNOWN || count[c] > count[best]) {
+      best = (ColorClass)c;
+    }
+  }
+  if (best == COLOR_UNKNOWN) {
+    return false;
+  }
+
+  // Find the start of the newest run of the new color, walking back from
+  // the latest reading; a single odd reading does not end the run, two in
+  // a row do (so an old noise spike is not taken as the start)
+  unsigned long firstSeen = sampleMs;
+  uint8_t firstAge = 0;
+  uint8_t misses = 0;
+  for (uint8_t i = 1; i <= vote->filled && misses < 2; i++) {
+    uint8_t slot = (vote->head + VOTE_WINDOW - i) % VOTE_WINDOW;
+    if (vote->votes[slot] == best) {
+      firstSeen = vote->votedAt[slot];
+      firstAge = i;
+      misses = 0;
+    } else {
+      misses++;
+    }
+  }
+
+  // The boundary lies between the reading before the run and the run's
+  // first reading; take the midpoint
+  unsigned long boundary = firstSeen;
+  uint16_t uncertainty = 0;
+  if (firstAge < vote->filled) {
+    uint8_t before = (vote->head + VOTE_WINDOW - firstAge - 1) % VOTE_WINDOW;
+    unsigned long gap = firstSeen - vote->votedAt[before];
+    boundary = firstSeen - gap / 2;
+    uncertainty = (uint16_t)min(gap / 2, 65535UL);
+  }
+
+  unsigned long latency = now - boundary;
+  LOG("[VOTE] %s -> %s (%u/%u votes, boundary %lu +/- %u ms ago)",
+      colorName(vote->stable), colorName(best), count[best], vote->filled, latency, uncertainty);
+
+  vote->previous = vote->stable;
+  vote->stable = best;
+  vote->since = boundary;
+  vote->uncertaintyMs = uncertainty;
+  vote->changed = true;
+  vote->changes++;
+  vote->latencyTotalMs += latency;
+  vote->latencyMaxMs = max(vote->latencyMaxMs, latency);
+  return true;
+}
+
+ColorClass colorVoteStable(const ColorVote* vote) {
+  return vote->stable;
+}
+
+bool colorVoteEntered(const ColorVote* vote, ColorClass color) {
+  return vote->changed && vote->stable == color;
+}
+
+bool colorVoteLeft(const ColorVote* vote, ColorClass color) {
+  return vote->changed && vote->previous == color;
+}
+
+unsigned long colorVoteSince(const ColorVote* vote) {
+  return vote->since;
+}
+
+uint16_t colorVoteUncertainty(const ColorVote* vote) {
+  return vote->uncertaintyMs;
+}
+
+/**
+ * Print change count and filter latency
+ */
+void colorVotePrint(const ColorVote* vote) {
+  Serial.print(F("[VOTE] Changes: "));
+  Serial.print(vote->changes);
+  Serial.print(F("  latency avg: "));
+  Serial.print(vote->changes ? vote->latencyTotalMs / vote->changes : 0);
+  Serial.print(F(" ms  max: "));
+  Serial.print(vote->latencyMaxMs);
+  Serial.println(F(" ms"));
+}
@@ -0,0 +1,59 @@
+/* Temporal voting filter on color class: k-of-n entry, sticky exit, timestamped boundaries. */
+#ifndef COLOR_VOTE_H
+#define COLOR_VOTE_H
+
+#include "Arduino.h"
+#include "color_sensor_func.h"
+
+// ============ COLOR VOTE CONFIGURATION ============
+#define VOTE_WINDOW 6  // Readings kept per filter (n of k-of-n)
+
+// Per-color rule, indexed by ColorClass. A color with enter == 0 never
+// becomes the stable color (use it for UNKNOWN and off-course colors).
+struct ColorVoteRule {
+  uint8_t enter;  // Votes of the last VOTE_WINDOW needed to switch to this color
+  uint8_t leave;  // Votes for other colors needed before this color can be left
+};
+
+// ============ COLOR VOTE RECORD ============
+// One instance per FSM
+struct ColorVote {
+  const ColorVoteRule* rules;             // COLOR_CLASS_COUNT entries
+  uint8_t votes[VOTE_WINDOW];             // Ring of recent readings
+  unsigned long votedAt[VOTE_WINDOW];     // Sample time of each reading
+  uint8_t head;                           // Next slot to write
+  uint8_t filled;                         // Readings in the ring
+  ColorClass stable;                      // Filtered color
+  ColorClass previous;                    // Stable color before the last change
+  bool changed;                           // Stable color changed on the last update
+  unsigned long since;                    // Estimated boundary time of the last change
+  uint16_t uncertaintyMs;                 // +/- of `since` (half the sample gap)
+  uint16_t changes;                       // Stable color changes so far
+  unsigned long latencyTotalMs;           // Sum of confirm - boundary delays
+  unsigned long latencyMaxMs;             // Longest confirm delay
+};
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Clear the ring and start from UNKNOWN
+void colorVoteBegin(ColorVote* vote, const ColorVoteRule* rules);
+
+// Add one reading taken at sampleMs (colorLastSampleMs()); true when the
+// stable color changed
+bool colorVoteUpdate(ColorVote* vote, ColorClass reading, unsigned long sampleMs);
+
+// Filtered color, and whether the last update switched to / away from `color`
+ColorClass colorVoteStable(const ColorVote* vote);
+bool colorVoteEntered(const ColorVote* vote, ColorClass color);
+bool colorVoteLeft(const ColorVote* vote, ColorClass color);
+
+// Estimated time the sensor crossed the boundary of the last change:
+// halfway between the last reading of the old color and the first of the
+// new one, so neither the vote delay nor the loop period is included
+unsigned long colorVoteSince(const ColorVote* vote);
+uint16_t colorVoteUncertainty(const ColorVote* vote);
+
+// Print change count and filter latency (average / max)
+void colorVotePrint(const ColorVote* vote);
+
+#endif  // COLOR_VOTE_H
@@ -0,0 +1,55 @@
+/* Flight recorder: RAM ring buffer of the last control ticks, dumped in binary over Serial. */
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "Arduino.h"
+
+// ============ FLIGHT RECORDER CONFIGURATION ============
+#define FR_CAPACITY    8    // Ticks kept (21 bytes each; sized to the Uno RAM budget)
+#define FR_DUMP_CMD    'd'  // Serial command: freeze, dump, resume
+#define FR_VERSION     2    // Bump when FlightFrame layout changes
+
+// Dump layout (little-endian):
+//   "FRD1" | version u8 | frameSize u8 | count u16 | ticks u32 | frames... | crc16 u16
+// Frames are oldest first. CRC-16/CCITT (0xFFFF init) covers version..last frame.
+#define FR_MAGIC "FRD1"
+
+// IR bit positions in FlightFrame::irBits
+#define FR_IR_LEFT   0x01
+#define FR_IR_RIGHT  0x02
+
+// ============ FRAME LAYOUT ============
+// Sensor modules write their latest values into flightLive as they read them;
+// flightRecorderTick() stamps it and copies it into the ring.
+struct __attribute__((packed)) FlightFrame {
+  uint32_t timeMs;       // millis() at the tick
+  uint8_t  state;        // FSM state value
+  uint8_t  color;        // ColorClass of last color read
+  uint16_t periodRed;    // Last raw periods (us, 0 = timeout)
+  uint16_t periodGreen;
+  uint16_t periodBlue;
+  uint8_t  irBits;       // FR_IR_LEFT | FR_IR_RIGHT when line seen
+  uint16_t distanceMm;   // Last ultrasonic distance (0 = none)
+  int16_t  motorLeft;    // Last wheel command: +forward, -backward
+  int16_t  motorRight;
+  uint16_t batteryMv;    // Filtered battery voltage (0 = no divider)
+};
+
+extern FlightFrame flightLive;
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Record one control tick (no-op while frozen)
+void flightRecorderTick(uint8_t state);
+
+// Stop/restart recording
+void flightRecorderFreeze();
+void flightRecorderResume();
+
+// Freeze, write the binary dump to Serial, then resume
+void flightRecorderDump();
+
+// Freeze permanently and dump once - call on fault or completion
+void flightRecorderDumpFinal();
+
+#endif  // FLIGHT_RECORDER_H
@@ -0,0 +1,169 @@
+/* FSM instrumentation: records where a run spent its time. */
+#include "fsm_stats.h"
+#include "log_sink.h"
+
+// ============ HELPERS ============
+
+/**
+ * Close out the dwell of the current state up to `now`
+ */
+static void closeDwell(FsmStats* stats, unsigned long now) {
+  FsmStateStats& current = stats->states[stats->current];
+  unsigned long dwell = now - stats->enteredAt;
+  current.totalMs += dwell;
+  if (dwell > current.maxMs) {
+    current.maxMs = dwell;
+  }
+}
+
+/**
+ * Count one from -> to transition, adding it to the table the first time
+ */
+static void countTransition(FsmStats* stats, uint8_t from, uint8_t to) {
+  for (uint8_t i = 0; i < stats->numTransitions; i++) {
+    FsmTransition& t = stats->transitions[i];
+    if (t.from == from && t.to == to) {
+      if (t.count < 255) {
+        t.count++;
+      }
+      return;
+    }
+  }
+  if (stats->numTransitions < stats->maxTransitions) {
+    FsmTransition& t = stats->transitions[stats->numTransitions++];
+    t.from = from;
+    t.to = to;
+    t.count = 1;
+  } else if (stats->untracked < 65535) {
+    stats->untracked++;
+  }
+}
+
+/**
+ * Print a value right-aligned in a fixed-width column
+ */
+static void printPadded(unsigned long value, uint8_t width) {
+  unsigned long limit = 10;
+  uint8_t digits = 1;
+  while (value >= limit && digits < 10) {
+    limit *= 10;
+    digits++;
+  }
+  for (uint8_t i = digits; i < width; i++) {
+    Serial.print(' ');
+  }
+  Serial.print(value);
+}
+
+/**
+ * Print a state name from flash, padded to `width`
+ */
+static void printName(const FsmStats* stats, uint8_t state, uint8_t width) {
+  const char* name = stats->names[state];
+  Serial.print(FLASH_STR(name));
+  for (uint8_t pad = FLASH_STRLEN(name); pad < width; pad++) {
+    Serial.print(' ');
+  }
+}
+
+// ============ RECORDING ============
+
+/**
+ * Reset all counters and start timing in the given initial state
+ */
+void fsmStatsBegin(FsmStats* stats, const StateName* names, FsmStateStats* states, uint8_t numStates,
+                   FsmTransition* transitions, uint8_t maxTransitions, uint8_t initialState) {
+  memset(stats, 0, sizeof(FsmStats));
+  memset(states, 0, numStates * sizeof(FsmStateStats));
+  stats->names = names;
+  stats->states = states;
+  stats->transitions = transitions;
+  stats->numStates = numStates;
+  stats->maxTransitions = maxTransitions;
+  stats->current = initialState;
+  stats->runStart = millis();
+  stats->enteredAt = stats->runStart;
+  states[initialState].entries = 1;
+}
+
+/**
+ * Record a state change since the previous tick
+ * Cheap when nothing changed: one compare
+ */
+void fsmStatsUpdate(FsmStats* stats, uint8_t state) {
+  if (state == stats->current || state >= stats->numStates) {
+    return;
+  }
+
+  unsigned long now = millis();
+  closeDwell(stats, now);
+  stats->enteredAt = now;
+
+  countTransition(stats, stats->current, state);
+  stats->states[state].entries++;
+  stats->current = state;
+}
+
+// ============ REPORTING ============
+
+/**
+ * Print per-state dwell table and the transitions that happened
+ * Format (times in ms):
+ *   #  STATE                 N   TOTAL     MAX
+ *   Transitions: from -> to  count, in the order first seen
+ */
+void fsmStatsPrint(FsmStats* stats) {
+  unsigned long now = millis();
+
+  // Fold the in-progress dwell into a copy so printing does not disturb recording
+  const FsmStateStats& current = stats->states[stats->current];
+  unsigned long total = current.totalMs + (now - stats->enteredAt);
+  unsigned long longest = max(current.maxMs, now - stats->enteredAt);
+
+  Serial.print(F("\n=== FSM STATS (run "));
+  Serial.print(now - stats->runStart);
+  Serial.println(F(" ms) ==="));
+  Serial.println(F(" # STATE                   N   TOTAL     MAX"));
+
+  for (uint8_t s = 0; s < stats->numStates; s++) {
+    bool isCurrent = (s == stats->current);
+    printPadded(s, 2);
+    Serial.print(' ');
+    printName(stats, s, 20);
+    printPadded(stats->states[s].entries, 5);
+    printPadded(isCurrent ? total : stats->states[s].totalMs, 8);
+    printPadded(isCurrent ? longest : stats->states[s].maxMs, 8);
+    Serial.println(isCurrent ? " *" : "");
+  }
+
+  Serial.println(F("Transitions (from -> to, count):"));
+  for (uint8_t i = 0; i < stats->numTransitions; i++) {
+    const FsmTransition& t = stats->transitions[i];
+    printPadded(t.from, 2);
+    Serial.print(' ');
+    printName(stats, t.from, 20);
+    Serial.print(F(" -> "));
+    printPadded(t.to, 2);
+    Serial.print(' ');
+    printName(stats, t.to, 20);
+    printPadded(t.count, 4);
+    Serial.println();
+  }
+  if (stats->untracked > 0) {
+    Serial.print(F("(table full: "));
+    Serial.print(stats->untracked);
+    Serial.println(F(" more not counted)"));
+  }
+  Serial.println(F("=============================="));
+}
+
+/**
+ * Print the table only the first time this is called
+ */
+void fsmStatsPrintOnce(FsmStats* stats) {
+  if (stats->printed) {
+    return;
+  }
+  stats->printed = true;
+  fsmStatsPrint(stats);
+}
@@ -1,5 +1,161 @@
 #include "Arduino.h"
 #include "motor_func.h"
+#include "flight_recorder.h"
+#include "odometry.h"
+#include "log_sink.h"
+#include "eeprom_layout.h"
+#include "crc16.h"
+#include "task.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+// ============ TIMED MANEUVER STATE ============
+// Timed turns/drives are started by the motor functions below and ended
+// by motorTask(), so callers wait with TASK_AWAIT_UNTIL(t, motorIdle()).
+static Task maneuverTask;
+static bool maneuverActive = false;
+static unsigned long maneuverMs = 0;        // Drive time
+static unsigned long maneuverSettleMs = 0;  // Stopped settle time after driving
+static bool braking = false;                // Current maneuver is a motorBrake()
+
+static const uint8_t STOP_SPEEDS[MOTOR_STOP_POINTS] = MOTOR_STOP_SPEEDS;
+static const uint8_t BRAKE_STOP_MM[MOTOR_STOP_POINTS] = MOTOR_BRAKE_STOP_MM;
+static const uint8_t COAST_STOP_MM[MOTOR_STOP_POINTS] = MOTOR_COAST_STOP_MM;
+
+// ============ TURN CALIBRATION STATE ============
+static TurnCalibration turnCal;
+static bool turnCalibrated = false;
+
+// ============ WHEEL CALIBRATION STATE ============
+static WheelCalibration wheelCal;
+static bool wheelCalibrated = false;
+
+// ============ BATTERY STATE ============
+static uint32_t batteryFiltered = 0;      // Filtered mV << BATTERY_FILTER_SHIFT (0 = no reading yet)
+static uint16_t batteryMv = 0;            // Filtered mV (0 = no divider)
+static unsigned long batterySampledAt = 0;
+static bool batteryLowWarned = false;
+static int drivenLeft = 0;                // Wheel PWM before compensation
+static int drivenRight = 0;
+
+// ============ WHEEL OUTPUT ============
+
+/**
+ * Drive one H-bridge channel
+ * @param speed Signed PWM: >0 forward, <0 backward, 0 coast
+ */
+static void driveWheel(uint8_t in1, uint8_t in2, uint8_t pwmPin, int speed) {
+  digitalWrite(in1, speed > 0 ? HIGH : LOW);
+  digitalWrite(in2, speed < 0 ? HIGH : LOW);
+  analogWrite(pwmPin, abs(speed));
+}
+
+/**
+ * PWM that delivers the motor voltage `pwm` gives at BATTERY_NOMINAL_MV
+ */
+static int batteryScaled(int pwm) {
+  if (!BATTERY_COMPENSATE || batteryMv == 0 || pwm == 0) {
+    return pwm;
+  }
+  long scaled = (long)pwm * BATTERY_NOMINAL_MV / batteryMv;
+  return constrain(scaled, -255, 255);
+}
+
+/**
+ * Drive both wheels with exact PWM and record it for the flight recorder
+ * The PWM is recorded before battery compensation: that is the motor
+ * voltage at nominal battery.
+ */
+static void driveWheelsPwm(int left, int right) {
+  drivenLeft = left;
+  drivenRight = right;
+  driveWheel(MOTOR_L_IN1, MOTOR_L_IN2, MOTOR_L_PWM, batteryScaled(left));
+  driveWheel(MOTOR_R_IN1, MOTOR_R_IN2, MOTOR_R_PWM, batteryScaled(right));
+  flightLive.motorLeft = left;
+  flightLive.motorRight = right;
+}
+
+/**
+ * Drive both wheels at requested speeds, through the wheel table
+ * Odometry gets the requested speeds: the table exists to make both wheels
+ * equally fast at the same request, which is what its single wheel model
+ * assumes. The trimmed PWMs would read as a turn.
+ */
+static void driveWheels(int left, int right) {
+  odometrySetWheels(left, right);
+  driveWheelsPwm(motorWheelPwm(0, left), motorWheelPwm(1, right));
+}
+
+/**
+ * Drive both wheels for a fixed time, then stop and settle
+ * Returns immediately; motorTask() ends the maneuver
+ */
+static void startManeuver(int left, int right, unsigned long timeMs, unsigned long settleMs) {
+  driveWheels(left, right);
+  braking = false;
+  maneuverMs = timeMs;
+  maneuverSettleMs = settleMs;
+  maneuverActive = true;
+  taskReset(&maneuverTask);
+}
+
+/**
+ * Drop any timed maneuver - continuous commands take over the wheels
+ */
+static void cancelManeuver() {
+  maneuverActive = false;
+  braking = false;
+  taskReset(&maneuverTask);
+}
+
+// ============ BATTERY ============
+
+/**
+ * Read the divider every BATTERY_SAMPLE_MS, filter, and re-drive the
+ * wheels at the new scale
+ * Warns once per discharge below BATTERY_LOW_MV.
+ */
+static void batteryUpdate() {
+  unsigned long now = millis();
+  if (batteryFiltered != 0 && now - batterySampledAt < BATTERY_SAMPLE_MS) {
+    return;
+  }
+  batterySampledAt = now;
+
+  uint16_t mv = analogRead(BATTERY_PIN) * (BATTERY_ADC_REF_MV * BATTERY_DIVIDER / 1023.0);
+  uint16_t filtered = 0;
+  if (mv >= BATTERY_MIN_MV && mv <= BATTERY_MAX_MV) {
+    if (batteryFiltered == 0) {
+      batteryFiltered = (uint32_t)mv << BATTERY_FILTER_SHIFT;  // First reading seeds the filter
+    } else {
+      batteryFiltered -= batteryFiltered >> BATTERY_FILTER_SHIFT;
+      batteryFiltered += mv;
+    }
+    filtered = batteryFiltered >> BATTERY_FILTER_SHIFT;
+  } else {
+    batteryFiltered = 0;
+  }
+
+  if (filtered != batteryMv) {
+    batteryMv = filtered;
+    flightLive.batteryMv = filtered;
+    if (!(braking && maneuverActive)) {
+      driveWheel(MOTOR_L_IN1, MOTOR_L_IN2, MOTOR_L_PWM, batteryScaled(drivenLeft));
+      driveWheel(MOTOR_R_IN1, MOTOR_R_IN2, MOTOR_R_PWM, batteryScaled(drivenRight));
+    }
+  }
+
+  if (batteryMv != 0 && batteryMv < BATTERY_LOW_MV && !batteryLowWarned) {
+    batteryLowWarned = true;
+    LOG("[MOTOR] Low battery: %u mV", batteryMv);
+  } else if (batteryMv >= BATTERY_LOW_MV + BATTERY_LOW_HYST_MV) {
+    batteryLowWarned = false;
+  }
+}
+
+uint16_t motorBatteryMv() {
+  return batteryMv;
+}
 
 // ============ MOTOR SETUP ============
 
@@ -18,7 +174,49 @@ void motorSetup() {
   // Start with motors stopped
   motorStop();
 
-  Serial.println("[MOTOR] Motor system initialized");
+  Serial.println(F("[MOTOR] Motor system initialized"));
+  batteryUpdate();
+  if (batteryMv != 0) {
+    Serial.print(F("[MOTOR] Battery: "));
+    Serial.print(batteryMv);
+    Serial.println(F(" mV"));
+  } else {
+    Serial.println(F("[MOTOR] No battery divider - PWM not compensated"));
+  }
+  if (motorWheelCalLoad()) {
+    Serial.println(F("[MOTOR] Wheel calibration loaded from EEPROM"));
+  }
+  if (motorTurnCalLoad()) {
+    Serial.println(F("[MOTOR] Turn calibration loaded from EEPROM"));
+  }
+}
+
+// ============ MOTION TASK ============
+
+/**
+ * Ends timed maneuvers without blocking and samples the battery
+ * Call from loop() every pass
+ */
+uint8_t motorTask() {
+  batteryUpdate();
+
+  Task* t = &maneuverTask;
+  TASK_BEGIN(t);
+
+  TASK_AWAIT_UNTIL(t, maneuverActive);
+  TASK_AWAIT_MS(t, maneuverMs);
+  driveWheels(0, 0);
+  TASK_AWAIT_MS(t, maneuverSettleMs);
+  maneuverActive = false;
+
+  TASK_END(t);
+}
+
+/**
+ * True when no timed maneuver is running
+ */
+bool motorIdle() {
+  return !maneuverActive;
 }
 
 // ============ MOTOR CONTROL FUNCTIONS ============
@@ -28,103 +226,146 @@ void motorSetup() {
  * Speed: 0-255 PWM value
  */
 void motorMoveForward(int speed) {
-  // Left motor forward
-  digitalWrite(MOTOR_L_IN1, HIGH);
-  digitalWrite(MOTOR_L_IN2, LOW);
-  analogWrite(MOTOR_L_PWM, speed);
+  cancelManeuver();
 
-  // Right motor forward
-  digitalWrite(MOTOR_R_IN1, HIGH);
-  digitalWrite(MOTOR_R_IN2, LOW);
-  analogWrite(MOTOR_R_PWM, speed);
+  // Both motors forward
+  driveWheels(speed, speed);
 
-  Serial.print("[MOTOR] Forward at speed: ");
-  Serial.println(speed);
+  LOG("[MOTOR] Forward at speed: %d", speed);
 }
 
 /**
  * Move robot backward at specified speed
  */
 void motorMoveBackward(int speed) {
-  // Left motor backward
-  digitalWrite(MOTOR_L_IN1, LOW);
-  digitalWrite(MOTOR_L_IN2, HIGH);
-  analogWrite(MOTOR_L_PWM, speed);
+  cancelManeuver();
 
-  // Right motor backward
-  digitalWrite(MOTOR_R_IN1, LOW);
-  digitalWrite(MOTOR_R_IN2, HIGH);
-  analogWrite(MOTOR_R_PWM, speed);
+  // Both motors backward
+  driveWheels(-speed, -speed);
 
-  Serial.print("[MOTOR] Backward at speed: ");
-  Serial.println(speed);
+  LOG("[MOTOR] Backward at speed: %d", speed);
+}
+
+/**
+ * Move robot forward for specified time, then stop
+ * Non-blocking: wait with TASK_AWAIT_UNTIL(t, motorIdle())
+ */
+void motorMoveForwardTime(int speed, unsigned long timeMs) {
+  LOG("[MOTOR] Forward at speed: %d for %lu ms", speed, timeMs);
+
+  startManeuver(speed, speed, timeMs, 0);
+}
+
+/**
+ * Move robot backward for specified time, then stop
+ * Non-blocking: wait with TASK_AWAIT_UNTIL(t, motorIdle())
+ */
+void motorMoveBackwardTime(int speed, unsigned long timeMs) {
+  LOG("[MOTOR] Backward at speed: %d for %lu ms", speed, timeMs);
+
+  startManeuver(-speed, -speed, timeMs, 0);
 }
 
 /**
  * Turn robot left for specified time
  * Left motor backward, right motor forward
+ * Non-blocking: wait with TASK_AWAIT_UNTIL(t, motorIdle())
  */
 void motorTurnLeft(int speed, unsigned long timeMs) {
-  Serial.print("[MOTOR] Turn left at speed: ");
-  Serial.print(speed);
-  Serial.print(" for ");
-  Serial.print(timeMs);
-  Serial.println(" ms");
-
-  // Left motor backward
-  digitalWrite(MOTOR_L_IN1, LOW);
-  digitalWrite(MOTOR_L_IN2, HIGH);
-  analogWrite(MOTOR_L_PWM, speed);
+  LOG("[MOTOR] Turn left at speed: %d for %lu ms", speed, timeMs);
 
-  // Right motor forward
-  digitalWrite(MOTOR_R_IN1, HIGH);
-  digitalWrite(MOTOR_R_IN2, LOW);
-  analogWrite(MOTOR_R_PWM, speed);
-
-  delay(timeMs);
-  motorStop();
+  // Left motor backward, right motor forward
+  startManeuver(-speed, speed, timeMs, 0);
 }
 
 /**
  * Turn robot right for specified time
  * Left motor forward, right motor backward
+ * Non-blocking: wait with TASK_AWAIT_UNTIL(t, motorIdle())
  */
 void motorTurnRight(int speed, unsigned long timeMs) {
-  Serial.print("[MOTOR] Turn right at speed: ");
-  Serial.print(speed);
-  Serial.print(" for ");
-  Serial.print(timeMs);
-  Serial.println(" ms");
-
-  // Left motor forward
-  digitalWrite(MOTOR_L_IN1, HIGH);
-  digitalWrite(MOTOR_L_IN2, LOW);
-  analogWrite(MOTOR_L_PWM, speed);
+  LOG("[MOTOR] Turn right at speed: %d for %lu ms", speed, timeMs);
 
-  // Right motor backward
-  digitalWrite(MOTOR_R_IN1, LOW);
-  digitalWrite(MOTOR_R_IN2, HIGH);
-  analogWrite(MOTOR_R_PWM, speed);
-
-  delay(timeMs);
-  motorStop();
+  // Left motor forward, right motor backward
+  startManeuver(speed, -speed, timeMs, 0);
 }
 
 /**
  * Stop all motors
+ * A running motorBrake() already ends in coast and is left to finish.
  */
 void motorStop() {
-  // Stop left motor
-  digitalWrite(MOTOR_L_IN1, LOW);
-  digitalWrite(MOTOR_L_IN2, LOW);
-  analogWrite(MOTOR_L_PWM, 0);
+  if (braking && maneuverActive) {
+    return;
+  }
+  cancelManeuver();
 
-  // Stop right motor
-  digitalWrite(MOTOR_R_IN1, LOW);
-  digitalWrite(MOTOR_R_IN2, LOW);
-  analogWrite(MOTOR_R_PWM, 0);
+  // Stop (coast) both motors
+  driveWheels(0, 0);
 
-  Serial.println("[MOTOR] Stop");
+  LOG("[MOTOR] Stop");
+}
+
+/**
+ * Short both motors for MOTOR_BRAKE_TIME, then coast
+ * Stops in a fraction of the coasting distance; any motion command ends it
+ * early. Non-blocking: motorIdle() is false until the brake is released.
+ */
+void motorBrake() {
+  if (braking && maneuverActive) {
+    return;
+  }
+
+  // IN1 = IN2 = HIGH with the enable full on: both motor leads shorted
+  digitalWrite(MOTOR_L_IN1, HIGH);
+  digitalWrite(MOTOR_L_IN2, HIGH);
+  analogWrite(MOTOR_L_PWM, 255);
+  digitalWrite(MOTOR_R_IN1, HIGH);
+  digitalWrite(MOTOR_R_IN2, HIGH);
+  analogWrite(MOTOR_R_PWM, 255);
+  drivenLeft = 0;
+  drivenRight = 0;
+  flightLive.motorLeft = 0;
+  flightLive.motorRight = 0;
+  odometrySetWheels(0, 0);
+
+  maneuverMs = MOTOR_BRAKE_TIME;
+  maneuverSettleMs = 0;
+  maneuverActive = true;
+  braking = true;
+  taskReset(&maneuverTask);
+
+  LOG("[MOTOR] Brake");
+}
+
+/**
+ * Roll-on after a stop command at `speed` (mm)
+ */
+unsigned long motorStopDistanceMm(int speed, bool braked) {
+  const uint8_t* mm = braked ? BRAKE_STOP_MM : COAST_STOP_MM;
+  speed = abs(speed);
+  if (speed <= STOP_SPEEDS[0]) {
+    return (unsigned long)mm[0] * speed / STOP_SPEEDS[0];
+  }
+  for (uint8_t i = 1; i < MOTOR_STOP_POINTS; i++) {
+    if (speed <= STOP_SPEEDS[i]) {
+      return mm[i - 1] + (unsigned long)(mm[i] - mm[i - 1]) * (speed - STOP_SPEEDS[i - 1]) /
+                         (STOP_SPEEDS[i] - STOP_SPEEDS[i - 1]);
+    }
+  }
+  return mm[MOTOR_STOP_POINTS - 1];
+}
+
+/**
+ * Roll-on after a stop command as ms of driving at `speed`
+ * Converted with the odometry wheel speed model
+ */
+unsigned long motorStopOvershootMs(int speed, bool braked) {
+  float mmPerS = fabs(odometryWheelSpeed(speed));
+  if (mmPerS <= 0) {
+    return 0;
+  }
+  return (unsigned long)(motorStopDistanceMm(speed, braked) * 1000.0 / mmPerS);
 }
 
 // ============ STEERING HELPERS ============
@@ -136,37 +377,40 @@ void motorStop() {
  * Steer robot left (stop left motor, keep right motor forward)
  */
 void steerLeft(int speed) {
-  // Left motor stop
-  digitalWrite(MOTOR_L_IN1, LOW);
-  digitalWrite(MOTOR_L_IN2, HIGH);
-  analogWrite(MOTOR_L_PWM, speed);
+  cancelManeuver();
 
-  // Right motor forward
-  digitalWrite(MOTOR_R_IN1, HIGH);
-  digitalWrite(MOTOR_R_IN2, LOW);
-  analogWrite(MOTOR_R_PWM, speed);
+  // Left motor backward, right motor forward
+  driveWheels(-speed, speed);
 
-  Serial.println("[Motor] Steering left!");
+  LOG("[Motor] Steering left!");
 }
 
 /**
  * Steer robot right (keep left motor forward, stop right motor)
  */
 void steerRight(int speed) {
-  // Left motor forward
-  digitalWrite(MOTOR_L_IN1, HIGH);
-  digitalWrite(MOTOR_L_IN2, LOW);
-  analogWrite(MOTOR_L_PWM, speed);
+  cancelManeuver();
 
-  // Right motor stop
-  digitalWrite(MOTOR_R_IN1, LOW);
-  digitalWrite(MOTOR_R_IN2, HIGH);
-  analogWrite(MOTOR_R_PWM, speed);
+  // Left motor forward, right motor backward
+  driveWheels(speed, -speed);
 
-  Serial.println("[Motor] Steering right!");
+  LOG("[Motor] Steering right!");
+}
+
+/**
+ * Drive each wheel at its own speed (arcs and spirals)
+ */
+void motorDrive(int left, int right) {
+  cancelManeuver();
+
+  driveWheels(left, right);
+
+  LOG("[MOTOR] Drive left: %d right: %d", left, right);
 }
 
 // ============ HELPER TURN FUNCTIONS ============
+// Non-blocking: each turn is followed by a MOTOR_SETTLE_TIME stop before
+// motorIdle() returns true.
 
 /**
  * Turn around 180 degrees
@@ -174,10 +418,8 @@ void steerRight(int speed) {
  * @param timeMs Duration of the turn in milliseconds
  */
 void turn180(int speed, unsigned long timeMs) {
-  Serial.println("[MOTOR] Executing 180-degree turn");
-  motorTurnRight(speed, timeMs);
-  delay(100);
-  motorStop();
+  LOG("[MOTOR] Executing 180-degree turn");
+  startManeuver(speed, -speed, motorTurnTime(speed, -180, timeMs / 2), MOTOR_SETTLE_TIME);
 }
 
 /**
@@ -186,10 +428,8 @@ void turn180(int speed, unsigned long timeMs) {
  * @param timeMs Duration of the turn in milliseconds
  */
 void turn90Left(int speed, unsigned long timeMs) {
-  Serial.println("[MOTOR] Executing 90-degree left turn");
-  motorTurnLeft(speed, timeMs);
-  delay(100);
-  motorStop();
+  LOG("[MOTOR] Executing 90-degree left turn");
+  startManeuver(-speed, speed, motorTurnTime(speed, 90, timeMs), MOTOR_SETTLE_TIME);
 }
 
 /**
@@ -198,8 +438,177 @@ void turn90Left(int speed, unsigned long timeMs) {
  * @param timeMs Duration of the turn in milliseconds
  */
 void turn90Right(int speed, unsigned long timeMs) {
-  Serial.println("[MOTOR] Executing 90-degree right turn");
-  motorTurnRight(speed, timeMs);
-  delay(100);
-  motorStop();
-}
\ No newline at end of file
+  LOG("[MOTOR] Executing 90-degree right turn");
+  startManeuver(speed, -speed, motorTurnTime(speed, -90, timeMs), MOTOR_SETTLE_TIME);
+}
+
+/**
+ * Turn by an arbitrary angle
+ * @param degrees Positive turns left, negative right
+ * @param msPer90 Uncalibrated time for 90 degrees
+ */
+void turnDegrees(int speed, int degrees, unsigned long msPer90) {
+  LOG("[MOTOR] Executing %d-degree turn", degrees);
+  if (degrees >= 0) {
+    startManeuver(-speed, speed, motorTurnTime(speed, degrees, msPer90), MOTOR_SETTLE_TIME);
+  } else {
+    startManeuver(speed, -speed, motorTurnTime(speed, degrees, msPer90), MOTOR_SETTLE_TIME);
+  }
+}
+
+// ============ TURN CALIBRATION ============
+
+/**
+ * Turn time for an angle
+ * The turn rate is interpolated linearly in PWM between the measured
+ * points of that direction and held at the end points outside them.
+ * @param degrees Positive left, negative right
+ * @param msPer90 Fallback when that direction is not calibrated
+ */
+unsigned long motorTurnTime(int speed, int degrees, unsigned long msPer90) {
+  unsigned long angle = abs(degrees);
+  if (!turnCalibrated) {
+    return msPer90 * angle / 90;
+  }
+
+  const uint16_t* revMs = turnCal.revMs[degrees >= 0 ? 0 : 1];
+  float rate = 0;          // Degrees per second at `speed`
+  float belowRate = 0;     // Nearest measured point at or below `speed`
+  float aboveRate = 0;     // ... and above it
+  int belowPwm = -1;
+  int abovePwm = -1;
+  for (uint8_t i = 0; i < TURN_CAL_POINTS; i++) {
+    if (revMs[i] == 0) {
+      continue;
+    }
+    float pointRate = 360000.0 / revMs[i];
+    if (turnCal.pwm[i] <= speed) {
+      belowPwm = turnCal.pwm[i];
+      belowRate = pointRate;
+    } else if (abovePwm < 0) {
+      abovePwm = turnCal.pwm[i];
+      aboveRate = pointRate;
+    }
+  }
+
+  if (belowPwm >= 0 && abovePwm >= 0) {
+    rate = belowRate + (aboveRate - belowRate) * (speed - belowPwm) / (abovePwm - belowPwm);
+  } else if (belowPwm >= 0) {
+    rate = belowRate;
+  } else if (abovePwm >= 0) {
+    rate = aboveRate;
+  }
+  if (rate <= 0) {
+    return msPer90 * angle / 90;
+  }
+  return (unsigned long)(angle * 1000.0 / rate + 0.5);
+}
+
+// CRC-16 of a record up to its crc field
+static uint16_t recordCrc(const void* record, uint8_t length) {
+  const uint8_t* bytes = (const uint8_t*)record;
+  uint16_t crc = CRC16_INIT;
+  for (uint8_t i = 0; i < length; i++) {
+    crc = crc16Update(crc, bytes[i]);
+  }
+  return crc;
+}
+
+static uint16_t turnCalCrc(const TurnCalibration& c) {
+  return recordCrc(&c, offsetof(TurnCalibration, crc));
+}
+
+/**
+ * Load the turn calibration; false (fixed turn times) if missing or corrupt
+ */
+bool motorTurnCalLoad() {
+  static_assert(sizeof(TurnCalibration) <= EEPROM_TURN_CAL_SIZE, "TurnCalibration outgrew its EEPROM slot");
+
+  EEPROM.get(EEPROM_TURN_CAL_ADDR, turnCal);
+  turnCalibrated = turnCal.magic == EEPROM_TURN_CAL_MAGIC &&
+                   turnCal.version == TURN_CAL_VERSION &&
+                   turnCal.crc == turnCalCrc(turnCal);
+  return turnCalibrated;
+}
+
+bool motorTurnCalibrated() {
+  return turnCalibrated;
+}
+
+/**
+ * Store a measured record and use it from now on
+ */
+void motorTurnCalSave(TurnCalibration* record) {
+  record->magic = EEPROM_TURN_CAL_MAGIC;
+  record->version = TURN_CAL_VERSION;
+  record->crc = turnCalCrc(*record);
+  EEPROM.put(EEPROM_TURN_CAL_ADDR, *record);
+  turnCal = *record;
+  turnCalibrated = true;
+}
+
+// ============ WHEEL CALIBRATION ============
+
+/**
+ * PWM for a requested wheel speed
+ * Linear between table entries; any nonzero request gets at least the
+ * deadband edge, zero stays zero (coast).
+ * @param wheel 0 = left, 1 = right
+ * @param speed Signed requested speed (-255..255)
+ */
+int motorWheelPwm(uint8_t wheel, int speed) {
+  if (!wheelCalibrated || speed == 0) {
+    return speed;
+  }
+  int magnitude = min(abs(speed), 255);
+  const uint8_t step = 255 / (WHEEL_CAL_STEPS - 1);
+  uint8_t index = min(magnitude / step, WHEEL_CAL_STEPS - 2);
+  int low = wheelCal.pwm[wheel][index];
+  int high = wheelCal.pwm[wheel][index + 1];
+  int pwm = low + (high - low) * (magnitude - index * step) / step;
+  pwm = constrain(pwm, 0, 255);
+  return speed > 0 ? pwm : -pwm;
+}
+
+static uint16_t wheelCalCrc(const WheelCalibration& c) {
+  return recordCrc(&c, offsetof(WheelCalibration, crc));
+}
+
+/**
+ * Load the wheel calibration; false (PWM = speed) if missing or corrupt
+ */
+bool motorWheelCalLoad() {
+  static_assert(sizeof(WheelCalibration) <= EEPROM_WHEEL_CAL_SIZE, "WheelCalibration outgrew its EEPROM slot");
+
+  EEPROM.get(EEPROM_WHEEL_CAL_ADDR, wheelCal);
+  wheelCalibrated = wheelCal.magic == EEPROM_WHEEL_CAL_MAGIC &&
+                    wheelCal.version == WHEEL_CAL_VERSION &&
+                    wheelCal.crc == wheelCalCrc(wheelCal);
+  return wheelCalibrated;
+}
+
+bool motorWheelCalibrated() {
+  return wheelCalibrated;
+}
+
+/**
+ * Store a measured table and use it from now on
+ */
+void motorWheelCalSave(WheelCalibration* record) {
+  record->magic = EEPROM_WHEEL_CAL_MAGIC;
+  record->version = WHEEL_CAL_VERSION;
+  record->crc = wheelCalCrc(*record);
+  EEPROM.put(EEPROM_WHEEL_CAL_ADDR, *record);
+  wheelCal = *record;
+  wheelCalibrated = true;
+}
+
+/**
+ * Exact PWM on both wheels, no table (wheel calibration measures through this)
+ * Raw PWMs are outside the odometry model, so the pose is held still.
+ */
+void motorDriveRaw(int left, int right) {
+  cancelManeuver();
+  odometrySetWheels(0, 0);
+  driveWheelsPwm(left, right);
+}
@@ -1,3 +1,6 @@
+#ifndef MOTOR_FUNC_H
+#define MOTOR_FUNC_H
+
 #include "Arduino.h"
 #include <string.h>
 #include <stdio.h>
@@ -12,22 +15,124 @@
 #define MOTOR_R_IN2  12  // Right motor direction pin 2
 #define MOTOR_R_PWM  5   // Right motor PWM (speed control)
 
+// ============ MOTION CONFIGURATION ============
+#define MOTOR_SETTLE_TIME 100  // ms stopped after turn90/turn180 before idle
+
+// ============ BRAKING ============
+// motorBrake() shorts both motors (IN1 = IN2 = HIGH) for MOTOR_BRAKE_TIME,
+// then coasts. Roll-on after the stop command, per approach speed: drive
+// over a tape mark, stop when the color sensor sees it, measure mark to
+// sensor. Interpolated in speed, held at the ends.
+#define MOTOR_BRAKE_TIME    80                    // ms of short before coasting
+#define MOTOR_STOP_POINTS   4
+#define MOTOR_STOP_SPEEDS   { 100, 150, 200, 255 }  // Ascending
+#define MOTOR_BRAKE_STOP_MM { 6, 12, 20, 30 }       // After motorBrake()
+#define MOTOR_COAST_STOP_MM { 15, 32, 55, 85 }      // After motorStop()
+
+// ============ BATTERY COMPENSATION ============
+// Motor battery (the 9 V battery on the L298N) through a resistor divider
+// on a spare analog pin. With BATTERY_COMPENSATE every wheel PWM is scaled
+// by nominal / measured voltage, so the motors see the same voltage (and
+// the timed turns and wheel table stay valid) as the battery drains. Off by
+// default: an unconnected pin floats and can read anything up to full
+// scale. Readings outside BATTERY_MIN_MV..BATTERY_MAX_MV are treated as no
+// divider: no scaling and no warning.
+#define BATTERY_PIN          A0
+#define BATTERY_DIVIDER      3.0    // (R1 + R2) / R2, e.g. 20k over 10k
+#define BATTERY_ADC_REF_MV   5000   // ADC full scale
+#define BATTERY_NOMINAL_MV   9000   // Voltage the speeds and calibrations assume
+#define BATTERY_LOW_MV       7200   // Warn below this (9 V alkaline near empty)
+#define BATTERY_LOW_HYST_MV  200    // Warn again only after recovering this far
+#define BATTERY_MIN_MV       5000   // Plausible range of a fitted divider:
+#define BATTERY_MAX_MV       10000  // a fresh 9 V reads about 9.6 V
+#define BATTERY_COMPENSATE   false  // true once the divider is fitted; false: measure and warn only
+#define BATTERY_SAMPLE_MS    100    // Time between readings
+#define BATTERY_FILTER_SHIFT 3      // Moving average weight 1/8 per reading
+
+// ============ TURN CALIBRATION ============
+// Measured turn rate per PWM and direction (see turn_cal), in EEPROM.
+// Without a record the callers' fixed turn times are used.
+#define TURN_CAL_VERSION 1
+#define TURN_CAL_POINTS  4                     // Turn PWMs measured
+#define TURN_CAL_PWMS    { 100, 120, 150, 180 }  // Ascending
+
+struct TurnCalibration {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t pwm[TURN_CAL_POINTS];
+  uint16_t revMs[2][TURN_CAL_POINTS];  // ms per revolution, [left, right] (0 = not measured)
+  uint16_t crc;
+};
+
+// ============ WHEEL CALIBRATION ============
+// Per-wheel table from requested speed to the PWM that gives that wheel
+// speed: trims the stronger motor and lifts small requests past the
+// deadband. Measured by turn_cal ('w'); without a record PWM = speed.
+#define WHEEL_CAL_VERSION 1
+#define WHEEL_CAL_STEPS   16  // Entries per wheel, for speed 0, 17, 34 ... 255
+
+struct WheelCalibration {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t pwm[2][WHEEL_CAL_STEPS];  // [left, right]; entry 0 is the deadband edge
+  uint16_t crc;
+};
+
 // ============ FUNCTION PROTOTYPES ============
 
 // Motor initialization
 void motorSetup();
 
+// Motion task - call from loop() every pass; ends timed maneuvers, samples the battery
+uint8_t motorTask();
+bool motorIdle();
+
 // Motor control functions
+// Timed functions return immediately; await motorIdle() for completion
 void motorMoveForward(int speed);
 void motorMoveBackward(int speed);
+void motorMoveForwardTime(int speed, unsigned long timeMs);
+void motorMoveBackwardTime(int speed, unsigned long timeMs);
 void motorTurnLeft(int speed, unsigned long timeMs);
 void motorTurnRight(int speed, unsigned long timeMs);
 void motorStop();
+void motorBrake();  // Non-blocking: shorts for MOTOR_BRAKE_TIME, then coasts
+
+// Stopping-distance model: roll-on after a stop command at `speed`, in mm
+// and as ms of driving at that speed (to extend a timed return leg)
+unsigned long motorStopDistanceMm(int speed, bool braked);
+unsigned long motorStopOvershootMs(int speed, bool braked);
 
 // Steering helpers (non-blocking, for continuous correction)
 void steerLeft(int speed);
 void steerRight(int speed);
+void motorDrive(int left, int right);  // Signed per-wheel speeds, e.g. arcs
 
+// Timed turns (non-blocking, include MOTOR_SETTLE_TIME)
+// With a turn calibration the time comes from it and timeMs is the fallback
 void turn180(int speed, unsigned long timeMs);
 void turn90Left(int speed, unsigned long timeMs);
-void turn90Right(int speed, unsigned long timeMs);
\ No newline at end of file
+void turn90Right(int speed, unsigned long timeMs);
+void turnDegrees(int speed, int degrees, unsigned long msPer90);  // + left, - right
+
+// Turn time for `degrees` (+ left, - right): calibrated, else msPer90 scaled
+unsigned long motorTurnTime(int speed, int degrees, unsigned long msPer90);
+
+// Filtered battery voltage (mV, 0 = no divider); sampled by motorTask()
+uint16_t motorBatteryMv();
+
+// Turn calibration record
+bool motorTurnCalLoad();
+bool motorTurnCalibrated();
+void motorTurnCalSave(TurnCalibration* record);  // Stamps magic/version/CRC, stores, uses
+
+// Wheel calibration record and lookup
+bool motorWheelCalLoad();
+bool motorWheelCalibrated();
+void motorWheelCalSave(WheelCalibration* record);  // Stamps magic/version/CRC, stores, uses
+int motorWheelPwm(uint8_t wheel, int speed);        // 0 = left, 1 = right; signed
+
+// Drive the wheels with exact PWM, bypassing the wheel table (calibration only)
+void motorDriveRaw(int left, int right);
+
+#endif  // MOTOR_FUNC_H
@@ -1,21 +1,119 @@
-/* Target FSM: edge→blue, half-time to center, 90° turn, find black. */
+/* Target FSM: edge→blue, half-time to center (or chord bisectors), 90° turn, find black, sweep fallback. */
 #include "navigate_target.h"
 #include "color_sensor_func.h"  // Include color sensor functions
 #include "motor_func.h"         // Include motor control functions
+#include "fsm_stats.h"          // Per-state dwell/transition instrumentation
+#include "state_watchdog.h"     // Per-state time budgets
+#include "color_vote.h"         // Filtered zone color
+#include "flight_recorder.h"    // Post-mortem ring buffer
+#include "log_sink.h"        // Non-blocking serial log
+#include "odometry.h"           // Pose relative to the first boundary
+#include "task.h"               // Cooperative waits for turns and drives
 
 // ============ GLOBAL STATE VARIABLES ============
 NavigationState currentState = STATE_MOVE_RANDOM;
 unsigned long startTime = 0;  // Start time for timing crossings
+static unsigned long overshootMs = 0;  // Driven past the far boundary, including the stop
 unsigned long crossingTimeMs = 0;  // Time to cross the target
 unsigned long greenCrossingTimeMs = 0;  // Time to cross green zone
 bool inGreenZone = false;  // Flag for green zone behavior
+static FsmStats navStats;  // Per-state dwell and transition counts
+static FsmStateStats navStateStats[STATE_COMPLETE + 1];
+static FsmTransition navTransitions[NAV_STATS_TRANSITIONS];
+static StateWatchdog navWatchdog;  // Per-state budgets
+static Task navTask;       // Resume point of the navigation task
+static ColorClass seen = COLOR_UNKNOWN;  // This tick's color reading
+static ColorVote navVote;  // Filtered zone color; zone changes are edges
+static unsigned long navStartMs = 0;  // Run start, for time-to-target
+static unsigned long navDoneMs = 0;   // Black found (0 while searching)
+static bool navAbandoned = false;     // Sweep ended without finding black
+static uint8_t searchPasses = 0;      // Boundary bounces in the current center search
+
+// ============ CHORD SEARCH STATE ============
+// Points are odometry positions (mm, origin at the boundary the search
+// started on). Brake roll-on happens with the wheels off, so odometry does
+// not see it; it is added from the stop-distance model.
+struct ChordPoint {
+  float x;
+  float y;
+};
+static ColorClass chordEdge = COLOR_BLUE;  // Boundary color of the zone being measured
+static ColorSet chordColors = 0;           // classifyAmong candidates in that zone
+static ChordPoint chordRollOn = { 0, 0 };  // Brake roll-on so far, not in the odometry pose
+static float legStartMm = 0;               // odometryDistance() when the current leg started
+static ChordPoint chordFrom[NAV_CHORDS];   // Exit boundary point of each chord
+static ChordPoint chordTo[NAV_CHORDS];     // Entry boundary point of each chord
+static uint8_t chordCount = 0;             // Complete chords
+static uint8_t chordLegs = 0;              // Legs driven, complete or not
+static bool chordOpen = false;             // Exit point of the current chord recorded
+static unsigned long chordExitMs = 0;      // Exit boundary time of the current chord
+static float centerTurnDeg = 0;            // Planned turn toward the center
+static float centerDriveMm = 0;            // Planned drive to the center
+
+// ============ SWEEP STATE ============
+static ColorClass sweepEdge = COLOR_BLUE;  // Boundary color of the zone being swept
+static ColorSet sweepColors = 0;           // classifyAmong candidates in that zone
+static uint8_t sweepLane = 0;              // Lanes started
+static uint8_t sweepLanes = 0;             // Lanes needed to cover the zone
+static unsigned long sweepLaneMaxMs = 0;   // Lane timeout (boundary missed)
+static unsigned long sweepStepMs = 0;      // Length of the current step between lanes
+static unsigned long sweepPhaseMs = 0;     // millis() the current lane or step started
+static unsigned long sweepDeadlineMs = 0;  // Worst-case end of the sweep
+static bool sweepStepping = false;         // Stepping over to the next lane
+static bool sweepTurnRight = false;        // Direction of the next lane-change turn
+
+// Voting rules {enter, leave} of the last VOTE_WINDOW readings, by ColorClass
+static const ColorVoteRule NAV_VOTE_RULES[COLOR_CLASS_COUNT] = {
+  { 0, 0 },  // UNKNOWN
+  { 4, 6 },  // BLACK - the goal, so demand a clear majority
+  { 3, 4 },  // RED
+  { 3, 4 },  // GREEN
+  { 3, 4 },  // BLUE
+  { 3, 3 },  // WHITE
+};
+
+// Surfaces each state can expect under the sensor (classifyAmong candidates)
+#define NAV_OUTER_COLORS (COLOR_SET(COLOR_WHITE) | COLOR_SET(COLOR_BLUE) | COLOR_SET(COLOR_RED) | \
+                          COLOR_SET(COLOR_GREEN) | COLOR_SET(COLOR_BLACK))
+#define NAV_GREEN_COLORS (COLOR_SET(COLOR_GREEN) | COLOR_SET(COLOR_RED) | COLOR_SET(COLOR_BLACK))
+
+// State names for the stats table (order must match NavigationState)
+static const StateName NAV_STATE_NAMES[] PROGMEM = {
+  "MOVE_RANDOM", "FOUND_FIRST_BLUE", "RETURN_HALF_TIME", "TURN_90_SEARCH",
+  "SEARCH_CENTER", "GREEN_ZONE", "GREEN_MOVE_RANDOM", "GREEN_FOUND_FIRST_RED",
+  "GREEN_RETURN_HALF", "GREEN_TURN_90", "GREEN_SEARCH_CENTER", "CHORD_START",
+  "CHORD_CROSS", "CHORD_TO_CENTER", "CHORD_DRIVE_CENTER", "SWEEP_START", "SWEEP",
+  "COMPLETE"
+};
+
+// Budget {ms, ticks} per visit, by NavigationState (0 = no limit)
+static const StateBudget NAV_BUDGETS[] PROGMEM = {
+  { NAV_WANDER_BUDGET_MS, NAV_WANDER_BUDGET_TICKS },  // MOVE_RANDOM
+  { NAV_CROSS_BUDGET_MS, NAV_CROSS_BUDGET_TICKS },    // FOUND_FIRST_BLUE
+  { 0, 0 },                                           // RETURN_HALF_TIME
+  { 0, 0 },                                           // TURN_90_SEARCH
+  { NAV_SEARCH_BUDGET_MS, NAV_SEARCH_BUDGET_TICKS },  // SEARCH_CENTER
+  { 0, 0 },                                           // GREEN_ZONE
+  { NAV_WANDER_BUDGET_MS, NAV_WANDER_BUDGET_TICKS },  // GREEN_MOVE_RANDOM
+  { NAV_CROSS_BUDGET_MS, NAV_CROSS_BUDGET_TICKS },    // GREEN_FOUND_FIRST_RED
+  { 0, 0 },                                           // GREEN_RETURN_HALF
+  { 0, 0 },                                           // GREEN_TURN_90
+  { NAV_SEARCH_BUDGET_MS, NAV_SEARCH_BUDGET_TICKS },  // GREEN_SEARCH_CENTER
+  { 0, 0 },                                           // CHORD_START
+  { NAV_SEARCH_BUDGET_MS, NAV_SEARCH_BUDGET_TICKS },  // CHORD_CROSS
+  { 0, 0 },                                           // CHORD_TO_CENTER
+  { 0, 0 },                                           // CHORD_DRIVE_CENTER - own timeout
+  { 0, 0 },                                           // SWEEP_START
+  { 0, 0 },                                           // SWEEP - own deadline
+  { 0, 0 },                                           // COMPLETE
+};
 
 // ============ HELPER FUNCTIONS ============
 
 /**
  * Get current color from sensor
  */
-char* getCurrentColor() {
+const char* getCurrentColor() {
   return readDominantColor();
 }
 
@@ -23,8 +121,7 @@ char* getCurrentColor() {
  * Check if black box is detected
  */
 bool isBlackBoxDetected() {
-  const char* color = getCurrentColor();
-  return strcmp(color, BLACK_BOX_DETECTED) == 0;
+  return colorIsBlack();  // Clear-filter fast path
 }
 
 /**
@@ -51,245 +148,724 @@ bool isRedZoneDetected() {
   return strcmp(color, "RED") == 0;
 }
 
+// ============ CHORD GEOMETRY ============
+
 /**
- * Move forward for specified time
+ * Add the roll-on of the brake just applied, along the current heading
  */
-void moveForwardTime(unsigned long timeMs) {
-  motorMoveForward(MOTOR_SPEED);
-  delay(timeMs);
-  motorStop();
+static void chordAddRollOn() {
+  float mm = motorStopDistanceMm(MOTOR_SPEED, true);
+  float heading = odometryPose().theta;
+  chordRollOn.x += cos(heading) * mm;
+  chordRollOn.y += sin(heading) * mm;
 }
 
-// ============ MAIN NAVIGATION ALGORITHM ============
-
-void navigateTargetFSM() {
-  
-  switch (currentState) {
-    
-    case STATE_MOVE_RANDOM: {
-      Serial.println("[NAV STATE] MOVE_RANDOM - Moving in starting direction");
-      motorMoveForward(MOTOR_SPEED);
-      
-      if (isBlueZoneDetected()) {
-        Serial.println("[NAV] Blue zone detected - stopping");
-        motorStop();
-        turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-        startTime = millis();
-
-        Serial.println("[NAV STATE] FOUND_FIRST_BLUE - Turning around to cross");
-        currentState = STATE_FOUND_FIRST_BLUE;
-      }
-      else if (isGreenZoneDetected()) {
-        Serial.println("[NAV] Green zone detected - entering green zone mode");
-        motorStop();
-        inGreenZone = true;
-        currentState = STATE_GREEN_ZONE;
-      }
-      else if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND!");
-        currentState = STATE_COMPLETE;
-        motorStop();
-      }
+/**
+ * Start measuring the zone bounded by `edge`
+ * The robot has just braked on that boundary, with odometry reset there
+ */
+static void chordBegin(ColorClass edge, ColorSet colors) {
+  chordEdge = edge;
+  chordColors = colors;
+  chordRollOn.x = 0;
+  chordRollOn.y = 0;
+  chordAddRollOn();
+  chordCount = 0;
+  chordLegs = 0;
+}
 
-      break; }
-    
-    case STATE_FOUND_FIRST_BLUE: {
-      motorMoveForward(MOTOR_SPEED);
-      
-      if (isBlueZoneDetected()) {
-        Serial.println("[NAV] Blue zone detected - stopping");
-        motorStop();
+/**
+ * Position at `ms` (a recent boundary time) on the current leg
+ * Legs are driven straight at MOTOR_SPEED, so the odometry pose is
+ * projected back along the heading by the time since.
+ */
+static ChordPoint chordPoseAt(unsigned long ms) {
+  OdoPose pose = odometryPose();
+  float mmPerMs = odometryWheelSpeed(MOTOR_SPEED) / 1000.0;
+  float back = mmPerMs * (long)(millis() - ms);
+  ChordPoint p;
+  p.x = pose.x + chordRollOn.x - cos(pose.theta) * back;
+  p.y = pose.y + chordRollOn.y - sin(pose.theta) * back;
+  return p;
+}
 
-        unsigned long arrivalTime = millis();
-        crossingTimeMs = arrivalTime - startTime;
+/**
+ * Turn in place by `deg` degrees (CCW positive); await motorIdle() after
+ */
+static void chordTurn(float deg) {
+  turnDegrees(MOTOR_TURN_SPEED, (int)deg, TURN_90_TIME);
+}
 
-        currentState = STATE_RETURN_HALF_TIME;
-      }
-      else if (isGreenZoneDetected()) {
-        Serial.println("[NAV] Green zone detected - entering green zone mode");
-        motorStop();
-        inGreenZone = true;
-        currentState = STATE_GREEN_ZONE;
-      }
-      else if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND!");
-        currentState = STATE_COMPLETE;
-        motorStop();
+/**
+ * Circle center from the perpendicular bisectors of the measured chords
+ * Each pair of bisectors meets at the center; pairs that are too close to
+ * parallel are skipped and the rest averaged.
+ * @return false when no usable pair exists
+ */
+static bool chordCenter(ChordPoint* center) {
+  float minSin = sin(radians(NAV_CHORD_MIN_ANGLE));
+  float sumX = 0;
+  float sumY = 0;
+  uint8_t used = 0;
+
+  for (uint8_t i = 0; i < chordCount; i++) {
+    for (uint8_t j = i + 1; j < chordCount; j++) {
+      // Bisector of chord k: d_k . X = d_k . midpoint_k
+      float ax = chordTo[i].x - chordFrom[i].x, ay = chordTo[i].y - chordFrom[i].y;
+      float bx = chordTo[j].x - chordFrom[j].x, by = chordTo[j].y - chordFrom[j].y;
+      float det = ax * by - ay * bx;
+      if (fabs(det) < minSin * sqrt(ax * ax + ay * ay) * sqrt(bx * bx + by * by)) {
+        continue;
       }
+      float ca = ax * (chordFrom[i].x + chordTo[i].x) / 2 + ay * (chordFrom[i].y + chordTo[i].y) / 2;
+      float cb = bx * (chordFrom[j].x + chordTo[j].x) / 2 + by * (chordFrom[j].y + chordTo[j].y) / 2;
+      sumX += (ca * by - cb * ay) / det;
+      sumY += (ax * cb - bx * ca) / det;
+      used++;
+    }
+  }
+
+  if (used == 0) {
+    return false;
+  }
+  center->x = sumX / used;
+  center->y = sumY / used;
+  return true;
+}
 
-      break; }
-    
-    case STATE_RETURN_HALF_TIME: {
-      Serial.println("[NAV STATE] RETURN_HALF_TIME - Moving back half distance");
-      delay(200);
-      turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-      unsigned long halfTime = crossingTimeMs / 2;
-      Serial.print("[NAV] Half time travel: ");
-      Serial.print(halfTime);
-      Serial.println(" ms");
-      moveForwardTime(halfTime);
-      
-      // Check if we found black box
-      if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND!");
-        currentState = STATE_COMPLETE;
-        motorStop();
-        break;
-      }
-      
-      currentState = STATE_TURN_90_SEARCH;
-      break; }
-    
-    case STATE_TURN_90_SEARCH: {
-      Serial.println("[NAV STATE] TURN_90_SEARCH - Turning 90 degrees");
-      delay(200);
-      turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
-      currentState = STATE_SEARCH_CENTER;
-      Serial.println("[NAV STATE] SEARCH_CENTER - Searching for center");
-      break;
-    
-    case STATE_SEARCH_CENTER:
-      motorMoveForward(MOTOR_SPEED);
-      
-      // Look for black box or blue zone
-      if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND!");
-        currentState = STATE_COMPLETE;
-        motorStop();
-        break;
-      }
-      else if (isBlueZoneDetected()) {
-        Serial.println("[NAV] Blue zone encountered during search");
-        motorStop();
-        delay(200);
-        turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-        motorMoveForward(MOTOR_SPEED);
-        // Continue moving - should encounter black box
-      }
-      else if (isGreenZoneDetected()) {
-        Serial.println("[NAV] Green zone detected - entering green zone mode");
-        inGreenZone = true;
-        currentState = STATE_GREEN_ZONE;
-        motorStop();
-        break;
-      }
-      break; }
+/**
+ * Turn and distance from the current position to the estimated center
+ * @return false when the chords do not fix a center
+ */
+static bool chordPlanCenter() {
+  ChordPoint center;
+  if (!chordCenter(&center)) {
+    return false;
+  }
+  ChordPoint here = chordPoseAt(millis());
+  float dx = center.x - here.x;
+  float dy = center.y - here.y;
+  float bearing = atan2(dy, dx) - odometryPose().theta;
+  while (bearing > PI) bearing -= 2 * PI;
+  while (bearing < -PI) bearing += 2 * PI;
+  centerTurnDeg = degrees(bearing);
+  centerDriveMm = sqrt(dx * dx + dy * dy);
+  LOG("[NAV] Center estimate from %u chords: turn %d deg, drive %d mm",
+      chordCount, (int)centerTurnDeg, (int)centerDriveMm);
+  return true;
+}
 
-    case STATE_GREEN_ZONE: {
-      Serial.println("[NAV STATE] GREEN_ZONE - Entering green circle mode");
-      Serial.println("[NAV] Adapting algorithm to use RED boundaries");
+// ============ SWEEP ============
 
-      // Transition to green zone movement
-      inGreenZone = true;
-      currentState = STATE_GREEN_MOVE_RANDOM;
-      break; }
+/**
+ * Plan a back-and-forth sweep of the zone bounded by `edge`
+ * Lanes NAV_SWEEP_LANE_MS apart cover a zone of the given diameter; the
+ * deadline assumes every lane runs to its timeout.
+ * @param diameterMs Measured crossing time of the zone (0 if unknown)
+ */
+static void sweepBegin(ColorClass edge, ColorSet colors, unsigned long diameterMs) {
+  if (diameterMs == 0) {
+    diameterMs = NAV_SWEEP_DEFAULT_MS;
+  }
+  sweepEdge = edge;
+  sweepColors = colors;
+  sweepLane = 0;
+  sweepLanes = min(diameterMs / NAV_SWEEP_LANE_MS + 1, (unsigned long)NAV_SWEEP_MAX_LANES);
+  sweepLaneMaxMs = diameterMs + diameterMs / 4;
+
+  // Turn times as the turns will run them: calibrated when a record exists.
+  // Lane changes alternate direction, so allow for the slower side.
+  unsigned long turn90Ms = max(motorTurnTime(MOTOR_TURN_SPEED, 90, TURN_90_TIME),
+                               motorTurnTime(MOTOR_TURN_SPEED, -90, TURN_90_TIME));
+  unsigned long turn180Ms = motorTurnTime(MOTOR_TURN_SPEED, -180, TURN_180_TIME / 2);
+  unsigned long perLane = sweepLaneMaxMs + NAV_SWEEP_LANE_MS +
+                          2 * (turn90Ms + MOTOR_SETTLE_TIME + COLOR_SENSE_DELAY);
+  unsigned long budget = turn180Ms + MOTOR_SETTLE_TIME + 200 + sweepLanes * perLane;
+  sweepDeadlineMs = millis() + budget;
+  LOG("[NAV] Sweep: %u lanes of up to %lu ms, done within %lu ms", sweepLanes, sweepLaneMaxMs, budget);
+}
 
-    case STATE_GREEN_MOVE_RANDOM: {
-      Serial.println("[NAV STATE] GREEN_MOVE_RANDOM - Moving until RED boundary");
-      motorMoveForward(MOTOR_SPEED);
+/**
+ * Quarter turn between a lane and a step; await motorIdle() after
+ */
+static void sweepTurn(bool right) {
+  if (right) {
+    turn90Right(MOTOR_TURN_SPEED, TURN_90_TIME);
+  } else {
+    turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
+  }
+}
 
-      if (isRedZoneDetected()) {
-        Serial.println("[NAV] RED boundary detected - stopping");
-        motorStop();
-        turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-        startTime = millis();
-        currentState = STATE_GREEN_FOUND_FIRST_RED;
-        Serial.println("[NAV STATE] GREEN_FOUND_FIRST_RED - Crossing green zone");
-      }
-      else if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND in green zone!");
-        currentState = STATE_COMPLETE;
-        motorStop();
-      }
-      break; }
+// ============ SETUP ============
 
-    case STATE_GREEN_FOUND_FIRST_RED: {
-      motorMoveForward(MOTOR_SPEED);
+/**
+ * Reset navigation state and instrumentation
+ * Call once from main setup()
+ */
+void targetSetup() {
+  currentState = STATE_MOVE_RANDOM;
+  crossingTimeMs = 0;
+  greenCrossingTimeMs = 0;
+  inGreenZone = false;
+  navStartMs = millis();
+  navDoneMs = 0;
+  navAbandoned = false;
+  searchPasses = 0;
+  taskReset(&navTask);
+  fsmStatsBegin(&navStats, NAV_STATE_NAMES, navStateStats, STATE_COMPLETE + 1,
+                navTransitions, NAV_STATS_TRANSITIONS, currentState);
+  watchdogBegin(&navWatchdog, "NAV", NAV_STATE_NAMES, NAV_BUDGETS, STATE_COMPLETE + 1, currentState);
+  colorVoteBegin(&navVote, NAV_VOTE_RULES);
+}
 
-      if (isRedZoneDetected()) {
-        Serial.println("[NAV] Opposite RED boundary detected");
-        motorStop();
+/**
+ * Current FSM state (for recording/instrumentation)
+ */
+NavigationState targetGetState() {
+  return currentState;
+}
 
-        unsigned long arrivalTime = millis();
-        greenCrossingTimeMs = arrivalTime - startTime;
+/**
+ * Print per-state dwell time and transition counts
+ * Called automatically on completion, or on serial request
+ */
+void targetPrintStats() {
+  fsmStatsPrint(&navStats);
+  watchdogPrint(&navWatchdog);
+  colorVotePrint(&navVote);
+}
 
-        Serial.print("[NAV] Green zone crossing time: ");
-        Serial.print(greenCrossingTimeMs);
-        Serial.println(" ms");
+// ============ MAIN NAVIGATION ALGORITHM ============
 
-        currentState = STATE_GREEN_RETURN_HALF;
-      }
-      else if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND while crossing green!");
-        currentState = STATE_COMPLETE;
-        motorStop();
+/**
+ * Navigation task - call from loop() every pass
+ * One FSM step per COLOR_SENSE_DELAY; turns and timed drives are awaited
+ * so the motion task and serial commands keep running.
+ */
+uint8_t navigateTargetFSM() {
+  Task* t = &navTask;
+  TASK_BEGIN(t);
+
+  while (true) {
+    fsmStatsUpdate(&navStats, currentState);
+
+    // Over budget: recover, then run the (possibly new) state as usual
+    if (watchdogCheck(&navWatchdog, currentState)) {
+      motorBrake();
+      TASK_AWAIT_UNTIL(t, motorIdle());
+      if (currentState == STATE_MOVE_RANDOM || currentState == STATE_GREEN_MOVE_RANDOM) {
+        // No boundary: pushing on something, or circling - back off and turn away
+        LOG("[NAV] No boundary found - backing up and turning away");
+        motorMoveBackwardTime(MOTOR_SPEED, NAV_RECOVER_REVERSE_MS);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        watchdogRestart(&navWatchdog);
+      } else if (currentState == STATE_FOUND_FIRST_BLUE || currentState == STATE_GREEN_FOUND_FIRST_RED) {
+        // The far boundary was missed: back off and wander to a new one
+        LOG("[NAV] Crossing found no far boundary - backing up and wandering again");
+        motorMoveBackwardTime(MOTOR_SPEED, NAV_RECOVER_REVERSE_MS);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        currentState = (currentState == STATE_FOUND_FIRST_BLUE) ? STATE_MOVE_RANDOM : STATE_GREEN_MOVE_RANDOM;
+      } else if (currentState == STATE_GREEN_SEARCH_CENTER ||
+                 (currentState == STATE_CHORD_CROSS && chordEdge == COLOR_RED)) {
+        LOG("[NAV] Green search over budget - sweeping the green zone");
+        sweepBegin(COLOR_RED, NAV_GREEN_COLORS, greenCrossingTimeMs);
+        currentState = STATE_SWEEP_START;
+      } else {
+        LOG("[NAV] Search over budget - sweeping the zone");
+        sweepBegin(COLOR_BLUE, NAV_OUTER_COLORS, crossingTimeMs);
+        currentState = STATE_SWEEP_START;
       }
-      break; }
-
-    case STATE_GREEN_RETURN_HALF: {
-      Serial.println("[NAV STATE] GREEN_RETURN_HALF - Moving to center of green zone");
-      delay(200);
-      turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-
-      unsigned long halfGreenTime = greenCrossingTimeMs / 2;
-      Serial.print("[NAV] Half time travel in green: ");
-      Serial.print(halfGreenTime);
-      Serial.println(" ms");
+    }
 
-      motorMoveForward(MOTOR_SPEED);
-      delay(halfGreenTime);
-      motorStop();
+    switch (currentState) {
 
-      // Check if we found black box
-      if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND at center of green!");
-        currentState = STATE_COMPLETE;
-        motorStop();
+      case STATE_MOVE_RANDOM: {
+        LOG("[NAV STATE] MOVE_RANDOM - Moving in starting direction");
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_OUTER_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        if (colorVoteEntered(&navVote, COLOR_BLUE)) {
+          LOG("[NAV] Blue zone detected - stopping");
+          motorBrake();
+          odometryReset(0, 0, 0);  // First boundary is the origin
+          if (NAV_USE_CHORDS) {
+            chordBegin(COLOR_BLUE, NAV_OUTER_COLORS);
+            currentState = STATE_CHORD_START;
+            break;
+          }
+          TASK_AWAIT_UNTIL(t, motorIdle());  // Let the brake finish
+          turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          startTime = millis();  // Replaced by the exit boundary once blue is left
+
+          LOG("[NAV STATE] FOUND_FIRST_BLUE - Turning around to cross");
+          currentState = STATE_FOUND_FIRST_BLUE;
+        }
+        else if (colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          motorBrake();
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+        }
+        else if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+
+        break; }
+
+      case STATE_FOUND_FIRST_BLUE: {
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_OUTER_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        // Leaving the blue we turned in starts the crossing
+        if (colorVoteLeft(&navVote, COLOR_BLUE)) {
+          startTime = colorVoteSince(&navVote);
+        }
+
+        if (colorVoteEntered(&navVote, COLOR_BLUE)) {
+          LOG("[NAV] Blue zone detected - stopping");
+          motorBrake();
+
+          unsigned long arrivalTime = colorVoteSince(&navVote);  // Boundary crossing
+          crossingTimeMs = arrivalTime - startTime;
+          overshootMs = millis() - arrivalTime + motorStopOvershootMs(MOTOR_SPEED, true);
+          LOG("[NAV] Crossing time: %lu ms (+/- %u), overshoot %lu ms",
+              crossingTimeMs, colorVoteUncertainty(&navVote), overshootMs);
+
+          currentState = STATE_RETURN_HALF_TIME;
+        }
+        else if (colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          motorBrake();
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+        }
+        else if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+
+        break; }
+
+      case STATE_RETURN_HALF_TIME: {
+        LOG("[NAV STATE] RETURN_HALF_TIME - Moving back half distance");
+        TASK_AWAIT_MS(t, 200);
+        turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        LOG("[NAV] Half time travel: %lu ms", crossingTimeMs / 2 + overshootMs);
+        motorMoveForwardTime(MOTOR_SPEED, crossingTimeMs / 2 + overshootMs);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+
+        // Check if we found black box
+        if (isBlackBoxDetected()) {
+          LOG("[NAV] BLACK BOX FOUND!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+          break;
+        }
+
+        currentState = STATE_TURN_90_SEARCH;
+        break; }
+
+      case STATE_TURN_90_SEARCH: {
+        LOG("[NAV STATE] TURN_90_SEARCH - Turning 90 degrees");
+        searchPasses = 0;
+        TASK_AWAIT_MS(t, 200);
+        turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        currentState = STATE_SEARCH_CENTER;
+        LOG("[NAV STATE] SEARCH_CENTER - Searching for center");
         break;
-      }
-
-      currentState = STATE_GREEN_TURN_90;
-      break; }
 
-    case STATE_GREEN_TURN_90: {
-      Serial.println("[NAV STATE] GREEN_TURN_90 - Turning perpendicular in green zone");
-      delay(200);
-      turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
-      currentState = STATE_GREEN_SEARCH_CENTER;
-      Serial.println("[NAV STATE] GREEN_SEARCH_CENTER - Searching perpendicular");
-      break;
-
-    case STATE_GREEN_SEARCH_CENTER:
-      motorMoveForward(MOTOR_SPEED);
+      case STATE_SEARCH_CENTER:
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_OUTER_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        // Look for black box or blue zone
+        if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+          break;
+        }
+        else if (colorVoteEntered(&navVote, COLOR_BLUE)) {
+          LOG("[NAV] Blue zone encountered during search");
+          motorBrake();
+          if (++searchPasses >= NAV_SWEEP_AFTER_PASSES) {
+            LOG("[NAV] %u passes without black - sweeping the zone", searchPasses);
+            sweepBegin(COLOR_BLUE, NAV_OUTER_COLORS, crossingTimeMs);
+            currentState = STATE_SWEEP_START;
+            break;
+          }
+          TASK_AWAIT_MS(t, 200);
+          turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          motorMoveForward(MOTOR_SPEED);
+          // Continue moving - should encounter black box
+        }
+        else if (colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+          motorBrake();
+          break;
+        }
+        break; }
+
+      case STATE_GREEN_ZONE: {
+        LOG("[NAV STATE] GREEN_ZONE - Entering green circle mode");
+        LOG("[NAV] Adapting algorithm to use RED boundaries");
+
+        // Transition to green zone movement once the entry brake has finished
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        inGreenZone = true;
+        currentState = STATE_GREEN_MOVE_RANDOM;
+        break; }
 
-      // Look for black box or red boundary
-      if (isBlackBoxDetected()) {
-        Serial.println("[NAV] BLACK BOX FOUND in green zone!");
-        currentState = STATE_COMPLETE;
-        motorStop();
+      case STATE_GREEN_MOVE_RANDOM: {
+        LOG("[NAV STATE] GREEN_MOVE_RANDOM - Moving until RED boundary");
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_GREEN_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        if (colorVoteEntered(&navVote, COLOR_RED)) {
+          LOG("[NAV] RED boundary detected - stopping");
+          motorBrake();
+          odometryReset(0, 0, 0);  // Green zone measurements start here
+          if (NAV_USE_CHORDS) {
+            chordBegin(COLOR_RED, NAV_GREEN_COLORS);
+            currentState = STATE_CHORD_START;
+            break;
+          }
+          TASK_AWAIT_UNTIL(t, motorIdle());  // Let the brake finish
+          turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          startTime = millis();  // Replaced by the exit boundary once red is left
+          currentState = STATE_GREEN_FOUND_FIRST_RED;
+          LOG("[NAV STATE] GREEN_FOUND_FIRST_RED - Crossing green zone");
+        }
+        else if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND in green zone!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        break; }
+
+      case STATE_GREEN_FOUND_FIRST_RED: {
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_GREEN_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        // Leaving the red we turned on starts the crossing
+        if (colorVoteLeft(&navVote, COLOR_RED)) {
+          startTime = colorVoteSince(&navVote);
+        }
+
+        if (colorVoteEntered(&navVote, COLOR_RED)) {
+          LOG("[NAV] Opposite RED boundary detected");
+          motorBrake();
+
+          unsigned long arrivalTime = colorVoteSince(&navVote);  // Boundary crossing
+          greenCrossingTimeMs = arrivalTime - startTime;
+          overshootMs = millis() - arrivalTime + motorStopOvershootMs(MOTOR_SPEED, true);
+
+          LOG("[NAV] Green zone crossing time: %lu ms (+/- %u), overshoot %lu ms",
+              greenCrossingTimeMs, colorVoteUncertainty(&navVote), overshootMs);
+
+          currentState = STATE_GREEN_RETURN_HALF;
+        }
+        else if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND while crossing green!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        break; }
+
+      case STATE_GREEN_RETURN_HALF: {
+        LOG("[NAV STATE] GREEN_RETURN_HALF - Moving to center of green zone");
+        TASK_AWAIT_MS(t, 200);
+        turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+
+        LOG("[NAV] Half time travel in green: %lu ms", greenCrossingTimeMs / 2 + overshootMs);
+
+        motorMoveForwardTime(MOTOR_SPEED, greenCrossingTimeMs / 2 + overshootMs);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+
+        // Check if we found black box
+        if (isBlackBoxDetected()) {
+          LOG("[NAV] BLACK BOX FOUND at center of green!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+          break;
+        }
+
+        currentState = STATE_GREEN_TURN_90;
+        break; }
+
+      case STATE_GREEN_TURN_90: {
+        LOG("[NAV STATE] GREEN_TURN_90 - Turning perpendicular in green zone");
+        searchPasses = 0;
+        TASK_AWAIT_MS(t, 200);
+        turn90Left(MOTOR_TURN_SPEED, TURN_90_TIME);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        currentState = STATE_GREEN_SEARCH_CENTER;
+        LOG("[NAV STATE] GREEN_SEARCH_CENTER - Searching perpendicular");
         break;
-      }
-      else if (isRedZoneDetected()) {
-        Serial.println("[NAV] RED boundary encountered during green search");
-        motorStop();
-        delay(200);
+
+      case STATE_GREEN_SEARCH_CENTER:
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(NAV_GREEN_COLORS);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        // Look for black box or red boundary
+        if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND in green zone!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+          break;
+        }
+        else if (colorVoteEntered(&navVote, COLOR_RED)) {
+          LOG("[NAV] RED boundary encountered during green search");
+          motorBrake();
+          if (++searchPasses >= NAV_SWEEP_AFTER_PASSES) {
+            LOG("[NAV] %u passes without black - sweeping the green zone", searchPasses);
+            sweepBegin(COLOR_RED, NAV_GREEN_COLORS, greenCrossingTimeMs);
+            currentState = STATE_SWEEP_START;
+            break;
+          }
+          TASK_AWAIT_MS(t, 200);
+          turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          LOG("[NAV] Searching opposite direction");
+          motorMoveForward(MOTOR_SPEED);
+          // Continue searching in opposite direction
+        }
+        break; }
+
+      // ---- Chord search: alternative to the half-time states above ----
+
+      case STATE_CHORD_START: {
+        LOG("[NAV STATE] CHORD_START - Chord %u of %u", chordCount + 1, NAV_CHORDS);
+        TASK_AWAIT_MS(t, 200);
+        chordTurn(chordLegs == 0 ? 180 : NAV_CHORD_TURN_DEG);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        legStartMm = odometryDistance();
+        chordOpen = false;
+        chordLegs++;
+        currentState = STATE_CHORD_CROSS;
+        break; }
+
+      case STATE_CHORD_CROSS: {
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(chordColors);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        if (colorVoteLeft(&navVote, chordEdge)) {
+          chordExitMs = colorVoteSince(&navVote);
+          chordFrom[chordCount] = chordPoseAt(chordExitMs);
+          chordOpen = true;
+        }
+
+        if (colorVoteEntered(&navVote, chordEdge)) {
+          motorBrake();
+          if (chordOpen) {
+            // Kept as the crossing time too, for the half-time fallback
+            unsigned long chordMs = colorVoteSince(&navVote) - chordExitMs;
+            chordTo[chordCount] = chordPoseAt(colorVoteSince(&navVote));
+            chordCount++;
+            overshootMs = millis() - colorVoteSince(&navVote) + motorStopOvershootMs(MOTOR_SPEED, true);
+            if (chordEdge == COLOR_RED) {
+              greenCrossingTimeMs = chordMs;
+            } else {
+              crossingTimeMs = chordMs;
+            }
+            LOG("[NAV] Chord %u: %lu ms", chordCount, chordMs);
+          } else {
+            LOG("[NAV] Chord without an exit boundary - not counted");
+          }
+          chordAddRollOn();
+
+          if (chordCount >= NAV_CHORDS) {
+            currentState = STATE_CHORD_TO_CENTER;
+          } else if (chordLegs >= NAV_CHORDS + 2) {
+            LOG("[NAV] Only %u chords after %u legs", chordCount, chordLegs);
+            currentState = STATE_CHORD_TO_CENTER;
+          } else {
+            currentState = STATE_CHORD_START;
+          }
+        }
+        else if (chordEdge == COLOR_BLUE && colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          motorBrake();
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+        }
+        else if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND while measuring chords!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        break; }
+
+      case STATE_CHORD_TO_CENTER: {
+        LOG("[NAV STATE] CHORD_TO_CENTER - Heading for the bisector intersection");
+        if (!chordPlanCenter()) {
+          // Fall back on the last chord: return half of it and search
+          LOG("[NAV] Chords do not fix a center - returning half the last chord");
+          currentState = chordEdge == COLOR_RED ? STATE_GREEN_RETURN_HALF : STATE_RETURN_HALF_TIME;
+          break;
+        }
+        TASK_AWAIT_MS(t, 200);
+        chordTurn(centerTurnDeg);
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        legStartMm = odometryDistance();
+        currentState = STATE_CHORD_DRIVE_CENTER;
+        break; }
+
+      case STATE_CHORD_DRIVE_CENTER: {
+        motorMoveForward(MOTOR_SPEED);
+        seen = classifyAmong(chordColors);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND at the estimated center!");
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        else if (chordEdge == COLOR_BLUE && colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          motorBrake();
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+        }
+        else if (colorVoteEntered(&navVote, chordEdge)) {
+          // Missed and reached the far side: bounce back along the same line
+          LOG("[NAV] Center missed - boundary reached, searching back");
+          motorBrake();
+          TASK_AWAIT_MS(t, 200);
+          turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          currentState = chordEdge == COLOR_RED ? STATE_GREEN_SEARCH_CENTER : STATE_SEARCH_CENTER;
+        }
+        else if (odometryDistance() - legStartMm > centerDriveMm * (100 + NAV_CENTER_MARGIN) / 100) {
+          LOG("[NAV] Center missed - continuing with the boundary search");
+          currentState = chordEdge == COLOR_RED ? STATE_GREEN_SEARCH_CENTER : STATE_SEARCH_CENTER;
+        }
+        break; }
+
+      // ---- Sweep: fallback after NAV_SWEEP_AFTER_PASSES failed passes ----
+
+      case STATE_SWEEP_START: {
+        // Stopped on the boundary facing out: turn in, step half a lane,
+        // then the first quarter turn puts the lanes parallel to the edge
+        LOG("[NAV STATE] SWEEP_START - Sweeping the zone in lanes");
+        TASK_AWAIT_MS(t, 200);
         turn180(MOTOR_TURN_SPEED, TURN_180_TIME);
-        Serial.println("[NAV] Searching opposite direction");
+        TASK_AWAIT_UNTIL(t, motorIdle());
+        sweepStepping = true;
+        sweepStepMs = NAV_SWEEP_LANE_MS / 2;
+        sweepTurnRight = false;
+        sweepPhaseMs = millis();
+        currentState = STATE_SWEEP;
+        break; }
+
+      case STATE_SWEEP: {
+        // Lanes and steps are both driven here, so color is read throughout
         motorMoveForward(MOTOR_SPEED);
-        // Continue searching in opposite direction
-      }
-      break; }
-    
-    case STATE_COMPLETE: {
-      Serial.println("[NAV STATE] COMPLETE - Navigation finished!");
-      motorStop();
-      Serial.println("=== NAVIGATION TARGET CHALLENGE COMPLETE ===");
-      return; }
-    
-    default: {
-      Serial.println("[NAV] ERROR: Unknown state");
-      motorStop();
-      currentState = STATE_COMPLETE;
-      break; }
+        seen = classifyAmong(sweepColors);
+        colorVoteUpdate(&navVote, seen, colorLastSampleMs());
+
+        if (colorVoteStable(&navVote) == COLOR_BLACK) {
+          LOG("[NAV] BLACK BOX FOUND during sweep (lane %u of %u)", sweepLane, sweepLanes);
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        else if (sweepEdge == COLOR_BLUE && colorVoteEntered(&navVote, COLOR_GREEN)) {
+          LOG("[NAV] Green zone detected - entering green zone mode");
+          motorBrake();
+          inGreenZone = true;
+          currentState = STATE_GREEN_ZONE;
+        }
+        else if ((long)(millis() - sweepDeadlineMs) > 0) {
+          LOG("[NAV] Sweep deadline reached - giving up");
+          navAbandoned = true;
+          currentState = STATE_COMPLETE;
+          motorBrake();
+        }
+        else if (sweepStepping) {
+          if (millis() - sweepPhaseMs >= sweepStepMs) {
+            // Second quarter turn: onto the next lane, heading back
+            motorBrake();
+            TASK_AWAIT_UNTIL(t, motorIdle());  // Let the brake finish
+            sweepTurn(sweepTurnRight);
+            TASK_AWAIT_UNTIL(t, motorIdle());
+            sweepTurnRight = !sweepTurnRight;
+            sweepStepping = false;
+            sweepLane++;
+            sweepPhaseMs = millis();
+            LOG("[NAV] Sweep lane %u of %u", sweepLane, sweepLanes);
+          }
+        }
+        else if (colorVoteEntered(&navVote, sweepEdge) ||
+                 // Still on the edge long after the turn: the vote never left it
+                 (colorVoteStable(&navVote) == sweepEdge && millis() - sweepPhaseMs > 2 * NAV_SWEEP_LANE_MS) ||
+                 millis() - sweepPhaseMs > sweepLaneMaxMs) {
+          motorBrake();
+          if (sweepLane >= sweepLanes) {
+            LOG("[NAV] Sweep covered the zone without black - giving up");
+            navAbandoned = true;
+            currentState = STATE_COMPLETE;
+            break;
+          }
+          // End of lane: first quarter turn, then step inward
+          TASK_AWAIT_UNTIL(t, motorIdle());  // Let the brake finish
+          sweepTurn(sweepTurnRight);
+          TASK_AWAIT_UNTIL(t, motorIdle());
+          sweepStepping = true;
+          sweepStepMs = NAV_SWEEP_LANE_MS;
+          sweepPhaseMs = millis();
+        }
+        break; }
+
+      case STATE_COMPLETE: {
+        LOG("[NAV STATE] COMPLETE - Navigation finished!");
+        motorStop();
+        if (navDoneMs == 0) {
+          navDoneMs = millis();
+          LOG("[NAV] %s after %lu ms (%s search)", navAbandoned ? "Search abandoned" : "Target found",
+              navDoneMs - navStartMs, NAV_USE_CHORDS ? "chord" : "half-time");
+          LOG("[NAV] Odometry: %d, %d mm from the first boundary (+/- %d mm)",
+              (int)odometryPose().x, (int)odometryPose().y, (int)odometryPositionSigma());
+        }
+        LOG("=== NAVIGATION TARGET CHALLENGE COMPLETE ===");
+        fsmStatsPrintOnce(&navStats);
+        flightRecorderDumpFinal();
+        break; }
+
+      default: {
+        LOG("[NAV] ERROR: Unknown state");
+        motorStop();
+        flightRecorderDumpFinal();
+        currentState = STATE_COMPLETE;
+        break; }
     }
+
+    // Record this tick, then wait for the next color reading slot
+    flightRecorderTick(currentState);
+    TASK_AWAIT_MS(t, COLOR_SENSE_DELAY);
+  }
+
+  TASK_END(t);
 }
+
@@ -7,9 +7,34 @@
 // ============ CONFIGURATION MACROS ============
 #define MOTOR_SPEED 150        // Motor PWM speed (0-255)
 #define MOTOR_TURN_SPEED 120   // Motor speed for turning (0-255)
-#define TURN_90_TIME 500       // Time in ms to turn 90 degrees
-#define TURN_180_TIME 1000     // Time in ms to turn 180 degrees
+#define TURN_90_TIME 500       // Time in ms to turn 90 degrees (until turn-calibrated)
+#define TURN_180_TIME 1000     // Time in ms to turn 180 degrees (until turn-calibrated)
 #define COLOR_SENSE_DELAY 50   // Delay in ms between color readings
+// Center search: false = half-time return + 90° turn, true = chord bisectors
+#define NAV_USE_CHORDS false
+#define NAV_CHORDS 2              // Chords measured before driving to the center (2-3)
+#define NAV_CHORD_TURN_DEG 120    // Turn at the boundary between chords
+#define NAV_CHORD_MIN_ANGLE 30    // Ignore bisector pairs crossing at less than this (degrees)
+#define NAV_CENTER_MARGIN 25      // Drive past the estimated center by this percent before giving up
+// Fallback sweep when the center search keeps missing
+#define NAV_SWEEP_AFTER_PASSES 3  // Boundary bounces in a center search before sweeping
+#define NAV_SWEEP_LANE_MS 250     // Lane spacing in drive-ms (about the black box width)
+#define NAV_SWEEP_MAX_LANES 16    // Caps the sweep, and with it the worst-case time
+#define NAV_SWEEP_DEFAULT_MS 3000 // Zone diameter (drive-ms) if no crossing was measured
+// State watchdog: budgets {ms, ticks} for the open-ended states (0 = no limit).
+// Wandering without a boundary backs up and turns away; a crossing that
+// never reaches the far boundary does the same and wanders again; a center
+// search or chord leg that runs long switches to the sweep, which has its
+// own deadline.
+#define NAV_WANDER_BUDGET_MS 15000  // MOVE_RANDOM / GREEN_MOVE_RANDOM
+#define NAV_WANDER_BUDGET_TICKS 0
+#define NAV_CROSS_BUDGET_MS 10000   // FOUND_FIRST_BLUE / GREEN_FOUND_FIRST_RED
+#define NAV_CROSS_BUDGET_TICKS 0
+#define NAV_SEARCH_BUDGET_MS 10000  // SEARCH_CENTER / GREEN_SEARCH_CENTER / CHORD_CROSS
+#define NAV_SEARCH_BUDGET_TICKS 0
+#define NAV_RECOVER_REVERSE_MS 400  // Back-up before turning away
+// FSM stats: distinct transitions counted (about 30 occur in a run)
+#define NAV_STATS_TRANSITIONS 32
 // Color strings for zone detection
 #define BLACK_BOX_DETECTED "BLACK"  // Black box color string
 #define BLUE_ZONE_COLOR "BLUE"     // Blue zone color string
@@ -28,16 +53,31 @@ enum NavigationState {
   STATE_GREEN_RETURN_HALF,     // Returning to center of green
   STATE_GREEN_TURN_90,         // Turning 90 in green zone
   STATE_GREEN_SEARCH_CENTER,   // Searching for black in green
+  STATE_CHORD_START,           // Turning into the zone for the next chord
+  STATE_CHORD_CROSS,           // Crossing, recording exit/entry boundary points
+  STATE_CHORD_TO_CENTER,       // Turning toward the bisector intersection
+  STATE_CHORD_DRIVE_CENTER,    // Driving to the estimated center
+  STATE_SWEEP_START,           // Turning back in from the boundary to sweep
+  STATE_SWEEP,                 // Back-and-forth lanes across the zone
   STATE_COMPLETE               // Navigation complete (black box found)
 };
 
 // ============ FUNCTION PROTOTYPES ============
 
-// Navigation main function
-void navigateTargetFSM();
+// Call once in setup() before navigating
+void targetSetup();
+
+// Navigation task - call from loop() every pass (never blocks)
+uint8_t navigateTargetFSM();
+
+// Current FSM state (for recording)
+NavigationState targetGetState();
+
+// Print per-state dwell/transition stats and watchdog trips (also printed once on completion)
+void targetPrintStats();
 
 // Helper functions
-char* getCurrentColor();
+const char* getCurrentColor();
 bool isBlackBoxDetected();
 bool isBlueZoneDetected();
 bool isGreenZoneDetected();
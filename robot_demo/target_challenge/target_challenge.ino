@@ -3,38 +3,82 @@
 #include "color_sensor_func.h"
 #include "navigate_target.h"
 #include "motor_func.h"
+#include "fsm_stats.h"
+#include "flight_recorder.h"
+#include "telemetry.h"
+#include "log_sink.h"
+#include "odometry.h"
+#include "task.h"
+
+static Task telemetryLoop;  // Binary telemetry frames
+static Task logLoop;        // Log drain and periodic drop report
+static Task odometryLoop;   // Pose integration
 
 void setup() {
-  Serial.begin(9600);
+  Serial.begin(TELEMETRY_BAUD);
   delay(200);
 
-  Serial.println("\n=== NAVIGATION TARGET CHALLENGE STARTED ===");
-
-  // Initialize color sensor
-  pinMode(PIN_S0, OUTPUT);
-  pinMode(PIN_S1, OUTPUT);
-  pinMode(PIN_S2, OUTPUT);
-  pinMode(PIN_S3, OUTPUT);
-  pinMode(PIN_OUT, INPUT);
+  Serial.println(F("\n=== NAVIGATION TARGET CHALLENGE STARTED ==="));
 
-  // Set frequency scaling to 20% (S0=HIGH, S1=LOW)
-  digitalWrite(PIN_S0, HIGH);
-  digitalWrite(PIN_S1, LOW);
+  // Initialize color sensor (pins, frequency scaling)
+  colorSensorSetup();
 
-  Serial.print("Color sensor initialized. Black threshold: ");
+  Serial.print(F("Color sensor initialized. Black threshold: "));
   Serial.println(BLACK_THRESHOLD);
+  if (colorCalibrationLoad()) {
+    Serial.println(F("Color calibration loaded from EEPROM"));
+  } else {
+    Serial.println(F("No color calibration - using black threshold (send 'c' to calibrate)"));
+  }
 
   // Initialize motor system
   motorSetup();
 
-  Serial.println("=== STARTING NAVIGATION ===\n");
+  // Initialize navigation FSM
+  targetSetup();
+
+  Serial.println(F("=== STARTING NAVIGATION ===\n"));
   delay(500);
 }
 
 void loop() {
-  // Call navigation state machine every cycle
+  // Check for serial commands
+  if (Serial.available() > 0) {
+    handleCommand(Serial.read());
+  }
+
+  // Cooperative tasks - navigation paces itself (COLOR_SENSE_DELAY)
+  motorTask();
+  odometryTask(&odometryLoop);
   navigateTargetFSM();
+  telemetryTask(&telemetryLoop);
+  logSinkTask(&logLoop);
+}
+
+void handleCommand(char cmd) {
+  switch (cmd) {
+    case FSM_STATS_CMD:
+      targetPrintStats();
+      break;
+
+    case FR_DUMP_CMD:
+      flightRecorderDump();
+      break;
+
+    case TELEMETRY_CMD:
+      telemetrySetEnabled(!telemetryEnabled());
+      break;
+
+    case LOG_STATS_CMD:
+      logReport();
+      break;
+
+    case COLOR_CAL_CMD:
+      colorCalibrationCommand();
+      break;
 
-  // Small delay to prevent sensor overload
-  delay(50);
+    case ODO_CMD:
+      odometryPrint();
+      break;
+  }
 }
@@ -0,0 +1,99 @@
+/* Binary telemetry: streams flightLive snapshots without blocking the control loop. */
+#include "telemetry.h"
+#include "crc16.h"
+
+// ============ TELEMETRY STATE ============
+static bool streaming = TELEMETRY_ON_AT_BOOT;
+static unsigned long droppedFrames = 0;
+
+// Raw frame and its COBS encoding (+1 code byte, +1 delimiter)
+static uint8_t rawFrame[1 + sizeof(FlightFrame) + 2];
+static uint8_t encodedFrame[sizeof(rawFrame) + 2];
+
+// ============ ENCODING ============
+
+/**
+ * COBS-encode len bytes so the output contains no 0x00
+ * @return Encoded length (without the trailing delimiter)
+ */
+static uint8_t cobsEncode(const uint8_t* in, uint8_t len, uint8_t* out) {
+  uint8_t codeIndex = 0;
+  uint8_t outIndex = 1;
+  uint8_t code = 1;
+
+  for (uint8_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = outIndex++;
+      code = 1;
+    } else {
+      out[outIndex++] = in[i];
+      code++;
+      if (code == 0xFF) {
+        out[codeIndex] = code;
+        codeIndex = outIndex++;
+        code = 1;
+      }
+    }
+  }
+  out[codeIndex] = code;
+  return outIndex;
+}
+
+/**
+ * Build and send one state frame if the TX buffer has room
+ * Never waits on the UART: a frame that does not fit is dropped
+ */
+static void sendStateFrame() {
+  FlightFrame snapshot = flightLive;
+  snapshot.timeMs = millis();
+
+  rawFrame[0] = TELEM_FRAME_STATE;
+  memcpy(&rawFrame[1], &snapshot, sizeof(FlightFrame));
+
+  uint16_t crc = CRC16_INIT;
+  for (uint8_t i = 0; i < 1 + sizeof(FlightFrame); i++) {
+    crc = crc16Update(crc, rawFrame[i]);
+  }
+  rawFrame[1 + sizeof(FlightFrame)] = crc & 0xFF;
+  rawFrame[2 + sizeof(FlightFrame)] = crc >> 8;
+
+  uint8_t len = cobsEncode(rawFrame, sizeof(rawFrame), encodedFrame);
+  encodedFrame[len++] = 0x00;
+
+  if (Serial.availableForWrite() < len) {
+    droppedFrames++;
+    return;
+  }
+  Serial.write(encodedFrame, len);
+}
+
+// ============ TELEMETRY TASK ============
+
+/**
+ * Send one frame every TELEMETRY_PERIOD_MS while enabled
+ */
+uint8_t telemetryTask(Task* t) {
+  TASK_BEGIN(t);
+
+  while (true) {
+    TASK_AWAIT_MS(t, TELEMETRY_PERIOD_MS);
+    if (streaming) {
+      sendStateFrame();
+    }
+  }
+
+  TASK_END(t);
+}
+
+void telemetrySetEnabled(bool enabled) {
+  streaming = enabled;
+}
+
+bool telemetryEnabled() {
+  return streaming;
+}
+
+unsigned long telemetryDropped() {
+  return droppedFrames;
+}
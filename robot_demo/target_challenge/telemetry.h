@@ -0,0 +1,32 @@
+/* Binary telemetry: COBS-framed, CRC-checked control-state frames at a fixed rate. */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "Arduino.h"
+#include "flight_recorder.h"
+#include "task.h"
+
+// ============ TELEMETRY CONFIGURATION ============
+#define TELEMETRY_BAUD       115200  // Serial baud for all sketches
+#define TELEMETRY_PERIOD_MS  20      // Frame interval (50 Hz)
+#define TELEMETRY_CMD        't'     // Serial command: toggle telemetry on/off
+#define TELEMETRY_ON_AT_BOOT false   // Start streaming without a command
+
+// Frame types (first payload byte)
+#define TELEM_FRAME_STATE 0x01  // Payload is a FlightFrame snapshot
+
+// On the wire: COBS( type u8 | FlightFrame | crc16 u16 ) followed by 0x00.
+// CRC-16/CCITT covers type and frame. Decode with tools/telemetry_plot.py.
+
+// ============ FUNCTION PROTOTYPES ============
+
+// Telemetry task - call from loop() every pass
+uint8_t telemetryTask(Task* t);
+
+void telemetrySetEnabled(bool enabled);
+bool telemetryEnabled();
+
+// Frames skipped because the TX buffer had no room
+unsigned long telemetryDropped();
+
+#endif  // TELEMETRY_H
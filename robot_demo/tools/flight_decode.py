@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+""" Decode a flight recorder dump (see flight_recorder.h) into CSV.
+
+Input is either a captured serial log file or a live serial port. The dump
+is found by its "FRD1" magic, so it can be mixed in with normal text output.
+
+    python3 flight_decode.py capture.bin --fsm obstacle > run.csv
+    python3 flight_decode.py --port /dev/ttyACM0 --fsm target
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+MAGIC = b"FRD1"
+HEADER = struct.Struct("<BBHI")           # version, frameSize, count, ticks
+FRAME = struct.Struct("<IBBHHHBHhhH")     # must match FlightFrame
+SUPPORTED_VERSION = 2
+
+COLOR_NAMES = ["UNKNOWN", "BLACK", "RED", "GREEN", "BLUE", "WHITE"]
+
+# State names per FSM (order must match the enums in the firmware)
+STATE_NAMES = {
+    "linefollow": ["LF_FORWARD", "LF_CORRECT_LEFT", "LF_CORRECT_RIGHT", "LF_STOPPED", "LF_LOST",
+                   "LF_JUNCTION"],
+    "obstacle": ["FOLLOW_RED", "PICKUP_BOX", "DROPOFF_BOX", "DODGE_TURN_RIGHT",
+                 "DODGE_PASS_SIDE", "DODGE_TURN_FORWARD", "DODGE_PASS_LENGTH",
+                 "DODGE_TURN_TO_LINE", "DODGE_FIND_RED", "DODGE_ALIGN", "COMPLETE"],
+    "target": ["MOVE_RANDOM", "FOUND_FIRST_BLUE", "RETURN_HALF_TIME", "TURN_90_SEARCH",
+               "SEARCH_CENTER", "GREEN_ZONE", "GREEN_MOVE_RANDOM", "GREEN_FOUND_FIRST_RED",
+               "GREEN_RETURN_HALF", "GREEN_TURN_90", "GREEN_SEARCH_CENTER", "CHORD_START",
+               "CHORD_CROSS", "CHORD_TO_CENTER", "CHORD_DRIVE_CENTER", "SWEEP_START", "SWEEP",
+               "COMPLETE"],
+}
+
+COLUMNS = ["time_ms", "state", "color", "period_r", "period_g", "period_b",
+           "ir_left", "ir_right", "distance_cm", "motor_left", "motor_right", "battery_mv"]
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, same as crc16Update() in crc16.h"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def find_dumps(data):
+    """Yield (ticks, frames) for every complete, CRC-valid dump in data"""
+    start = data.find(MAGIC)
+    while start >= 0:
+        body = start + len(MAGIC)
+        if len(data) < body + HEADER.size:
+            return
+        version, frame_size, count, ticks = HEADER.unpack_from(data, body)
+        end = body + HEADER.size + count * frame_size
+        if version != SUPPORTED_VERSION or frame_size != FRAME.size or len(data) < end + 2:
+            print(f"Skipping dump at offset {start}: unsupported or truncated", file=sys.stderr)
+        else:
+            (crc,) = struct.unpack_from("<H", data, end)
+            if crc != crc16(data[body:end]):
+                print(f"Skipping dump at offset {start}: CRC mismatch", file=sys.stderr)
+            else:
+                frames = [FRAME.unpack_from(data, body + HEADER.size + i * frame_size)
+                          for i in range(count)]
+                yield ticks, frames
+        start = data.find(MAGIC, body)
+
+
+def frame_to_row(frame, state_names):
+    """Convert one unpacked frame to a CSV row"""
+    t, state, color, r, g, b, ir, dist_mm, left, right, battery_mv = frame
+    state_label = state_names[state] if state < len(state_names) else state
+    color_label = COLOR_NAMES[color] if color < len(COLOR_NAMES) else color
+    return [t, state_label, color_label, r, g, b,
+            int(bool(ir & 0x01)), int(bool(ir & 0x02)), dist_mm / 10.0, left, right, battery_mv]
+
+
+def read_port(port, baud):
+    """Read from a serial port until a dump has arrived (Ctrl+C to stop early)"""
+    import serial  # pyserial, only needed for live capture
+
+    data = bytearray()
+    with serial.Serial(port, baud, timeout=1) as ser:
+        print("Waiting for dump (send 'd' or wait for completion)...", file=sys.stderr)
+        try:
+            while True:
+                data += ser.read(256)
+                if any(True for _ in find_dumps(bytes(data))):
+                    return bytes(data)
+        except KeyboardInterrupt:
+            return bytes(data)
+
+
+def main():
+    """Parse arguments, decode every dump found, write CSV to stdout"""
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", nargs="?", help="Captured serial output")
+    parser.add_argument("--port", help="Serial port to read a live dump from")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--fsm", choices=sorted(STATE_NAMES), help="Name states using this FSM's enum")
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args.port, args.baud)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    state_names = STATE_NAMES.get(args.fsm, [])
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["dump"] + COLUMNS)
+    found = 0
+    for ticks, frames in find_dumps(data):
+        found += 1
+        print(f"Dump {found}: {len(frames)} frames (of {ticks} ticks recorded)", file=sys.stderr)
+        for frame in frames:
+            writer.writerow([found] + frame_to_row(frame, state_names))
+
+    if found == 0:
+        print("No valid dump found", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
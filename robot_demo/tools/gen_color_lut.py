@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+""" Generate color_lut.h: a 16x16x16 color class table for color_sensor_func.
+
+Each axis is one filter period (R, G, B, in us at the 20% reference
+scaling) in half-octave bins, so the firmware indexes the table with a bit
+scan and shifts. Every cell is classified once, here, with the same
+nearest-centroid math the firmware uses, and stored as a 4-bit ColorClass.
+
+Centroids come from the calibration printout ('c' command, "[CAL] RED:
+R=.. G=.. B=.." lines) or the command line. --threshold rebuilds the
+original shortest-period rule instead (the checked-in default).
+
+    python3 gen_color_lut.py --cal-log calibration.txt -o ../main/color_lut.h
+    python3 gen_color_lut.py --centroid RED=60,160,130 --centroid WHITE=40,42,38 ...
+    python3 gen_color_lut.py --threshold 125 -o ../main/color_lut.h
+
+Classes are read from the ColorClass enum, so a new enum entry (YELLOW)
+just needs a centroid - the firmware lookup does not change.
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+BINS = 16
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_HEADER = os.path.join(HERE, "..", "main", "color_sensor_func.h")
+CAL_LINE = re.compile(r"\[CAL\]\s+(\w+):\s+R=(\d+)\s+G=(\d+)\s+B=(\d+)")
+
+
+def read_enum(header):
+    """ColorClass names in enum order (COLOR_CLASS_COUNT excluded)"""
+    text = open(header).read()
+    body = re.search(r"enum\s+ColorClass\s*\{(.*?)\}", text, re.S).group(1)
+    names = []
+    for entry in body.split(","):
+        entry = re.sub(r"//.*", "", entry).strip()
+        if entry and entry != "COLOR_CLASS_COUNT":
+            names.append(entry.replace("COLOR_", ""))
+    return names
+
+
+def read_define(header, name, default):
+    m = re.search(r"#define\s+%s\s+(\d+)" % name, open(header).read())
+    return int(m.group(1)) if m else default
+
+
+def bin_center(k):
+    """Representative period (us) of bin k - mirrors lutBin() in the firmware"""
+    if k == BINS - 1:
+        return 1024  # Also holds >= 1024 us and timeouts
+    octave = k // 2 + 2
+    low = (1 << octave) + (k % 2) * (1 << (octave - 1))
+    return low + (1 << (octave - 1)) / 2.0
+
+
+# ---- classifiers (same math as color_sensor_func.cpp) ----
+
+def to_hz(p):
+    return 1e6 / p if p > 0 else 0.0
+
+
+def feature(p, reference_hz):
+    hz = [to_hz(x) for x in p]
+    total = sum(hz)
+    if total == 0:
+        return (0, 0, 0, 0)
+    chroma = [1000.0 * h / total for h in hz]
+    brightness = min(1000.0 * total / reference_hz, 1000.0) if reference_hz else 0
+    return (chroma[0], chroma[1], chroma[2], brightness)
+
+
+def nearest_classifier(centroids, names, max_distance):
+    reference_hz = max(sum(to_hz(x) for x in p) for p in centroids.values())
+    feats = {name: feature(p, reference_hz) for name, p in centroids.items()}
+
+    def classify(p):
+        f = feature(p, reference_hz)
+        best, best_d = "UNKNOWN", None
+        for name, c in feats.items():
+            d = math.sqrt(sum((a - b) ** 2 for a, b in zip(f, c)))
+            if best_d is None or d < best_d:
+                best, best_d = name, d
+        return best if best_d is not None and best_d <= max_distance else "UNKNOWN"
+    return classify
+
+
+def threshold_classifier(black_threshold):
+    def classify(p):
+        r, g, b = p
+        if r > black_threshold and g > black_threshold and b > black_threshold:
+            return "BLACK"
+        m = min(r, g, b)
+        return "RED" if m == r else "GREEN" if m == g else "BLUE"
+    return classify
+
+
+# ---- output ----
+
+def build_table(classify, names):
+    table = bytearray(BINS ** 3 // 2)
+    counts = dict.fromkeys(names, 0)
+    for r in range(BINS):
+        for g in range(BINS):
+            for b in range(BINS):
+                name = classify((bin_center(r), bin_center(g), bin_center(b)))
+                value = names.index(name)
+                counts[name] += 1
+                index = (r << 8) | (g << 4) | b
+                table[index >> 1] |= value << 4 if index & 1 else value
+    return table, counts
+
+
+def write_header(path, table, source, counts):
+    lines = [
+        "/* Color class lookup table - generated by tools/gen_color_lut.py, do not edit. */",
+        "// Source: %s" % source,
+        "// Cells: %s" % ", ".join("%s %d" % kv for kv in counts.items() if kv[1]),
+        "#ifndef COLOR_LUT_H",
+        "#define COLOR_LUT_H",
+        "",
+        "#define COLOR_LUT_BINS %d  // Per axis; index = R << 8 | G << 4 | B, two cells per byte" % BINS,
+        "",
+        "static const uint8_t COLOR_LUT[%d] PROGMEM = {" % len(table),
+    ]
+    for i in range(0, len(table), 16):
+        lines.append("  " + ", ".join("0x%02X" % x for x in table[i:i + 16]) + ",")
+    lines += ["};", "", "#endif  // COLOR_LUT_H", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--header", default=DEFAULT_HEADER, help="color_sensor_func.h with the ColorClass enum")
+    ap.add_argument("--cal-log", help="serial capture containing the [CAL] lines")
+    ap.add_argument("--centroid", action="append", default=[], metavar="NAME=R,G,B",
+                    help="mean periods of one surface (repeatable)")
+    ap.add_argument("--threshold", type=int, metavar="US",
+                    help="rebuild the original BLACK_THRESHOLD / shortest-period rule")
+    ap.add_argument("-o", "--output", action="append", default=[],
+                    help="color_lut.h to write (repeatable; default: stdout summary only)")
+    args = ap.parse_args()
+
+    names = read_enum(args.header)
+    if len(names) > 16:
+        sys.exit("ColorClass has %d entries - 4-bit cells hold 16" % len(names))
+
+    if args.threshold is not None:
+        classify = threshold_classifier(args.threshold)
+        source = "threshold rule, BLACK_THRESHOLD %d us" % args.threshold
+    else:
+        centroids = {}
+        if args.cal_log:
+            for m in CAL_LINE.finditer(open(args.cal_log, errors="replace").read()):
+                centroids[m.group(1)] = tuple(int(x) for x in m.group(2, 3, 4))
+        for spec in args.centroid:
+            name, values = spec.split("=")
+            centroids[name.upper()] = tuple(int(x) for x in values.split(","))
+        if not centroids:
+            sys.exit("no centroids: use --cal-log, --centroid or --threshold")
+        unknown = [n for n in centroids if n not in names]
+        if unknown:
+            sys.exit("not in the ColorClass enum: %s" % ", ".join(unknown))
+        max_distance = read_define(args.header, "COLOR_MAX_DISTANCE", 250)
+        classify = nearest_classifier(centroids, names, max_distance)
+        source = "centroids " + " ".join("%s=%d,%d,%d" % ((n,) + p) for n, p in centroids.items())
+
+    table, counts = build_table(classify, names)
+    for path in args.output:
+        write_header(path, table, source, counts)
+        print("wrote %s" % path, file=sys.stderr)
+    print(", ".join("%s %d" % kv for kv in counts.items()), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+""" Live plot / CSV logger for the robot's binary telemetry (see telemetry.h).
+
+Frames are COBS-encoded and 0x00-delimited, so they can share the port with
+normal text prints: anything that is not a valid frame is echoed as text.
+Send 't' to the robot (this tool does it with --start) to toggle streaming.
+
+    python3 telemetry_plot.py --port /dev/ttyACM0 --start --fsm obstacle
+    python3 telemetry_plot.py --port /dev/ttyACM0 --start --csv run.csv --no-plot
+"""
+
+import argparse
+import collections
+import csv
+import struct
+import sys
+
+from flight_decode import COLUMNS, FRAME, STATE_NAMES, crc16, frame_to_row
+
+FRAME_STATE = 0x01
+RAW_LEN = 1 + FRAME.size + 2          # type + FlightFrame + crc16
+ENCODED_LEN = RAW_LEN + 1             # COBS adds one code byte (< 254 bytes)
+HISTORY = 500                         # Samples kept on screen
+
+
+def cobs_decode(data):
+    """Decode one COBS block (without the 0x00 delimiter); None if malformed"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data) + 1:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(block):
+    """Return the unpacked FlightFrame for a valid state frame, else None"""
+    raw = cobs_decode(block)
+    if raw is None or len(raw) != RAW_LEN or raw[0] != FRAME_STATE:
+        return None
+    (crc,) = struct.unpack_from("<H", raw, RAW_LEN - 2)
+    if crc != crc16(raw[:RAW_LEN - 2]):
+        return None
+    return FRAME.unpack_from(raw, 1)
+
+
+def split_chunk(chunk):
+    """Split a delimited chunk into (leading text, frame or None)
+
+    Frames have a fixed encoded length, so text printed just before a frame
+    is whatever precedes the last ENCODED_LEN bytes.
+    """
+    if len(chunk) >= ENCODED_LEN:
+        frame = parse_frame(chunk[-ENCODED_LEN:])
+        if frame is not None:
+            return chunk[:-ENCODED_LEN], frame
+    return chunk, None
+
+
+class Stream:
+    """Reads the port, yields frames, echoes text and counts CRC failures"""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.buffer = bytearray()
+        self.frames = 0
+        self.bad = 0
+
+    def poll(self):
+        self.buffer += self.ser.read(self.ser.in_waiting or 1)
+        while True:
+            end = self.buffer.find(b"\x00")
+            if end < 0:
+                return
+            chunk = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            text, frame = split_chunk(chunk)
+            if text:
+                sys.stderr.write(text.decode("ascii", errors="replace"))
+            if frame is not None:
+                self.frames += 1
+                yield frame
+            elif len(chunk) == ENCODED_LEN:
+                self.bad += 1
+
+
+def run_plot(stream, state_names, writer):
+    """Animate periods, wheel commands, distance and state"""
+    import matplotlib.pyplot as plt
+    from matplotlib.animation import FuncAnimation
+
+    data = collections.defaultdict(lambda: collections.deque(maxlen=HISTORY))
+    fig, (ax_color, ax_motor, ax_state) = plt.subplots(3, 1, sharex=True, figsize=(10, 8))
+    lines = {
+        "period_r": ax_color.plot([], [], "r-", label="R period (us)")[0],
+        "period_g": ax_color.plot([], [], "g-", label="G period (us)")[0],
+        "period_b": ax_color.plot([], [], "b-", label="B period (us)")[0],
+        "motor_left": ax_motor.plot([], [], "-", label="left PWM")[0],
+        "motor_right": ax_motor.plot([], [], "-", label="right PWM")[0],
+        "distance_cm": ax_motor.plot([], [], "k:", label="distance (cm)")[0],
+        "state": ax_state.step([], [], where="post", label="state")[0],
+        "ir": ax_state.plot([], [], ".", label="IR bits")[0],
+    }
+    for ax in (ax_color, ax_motor, ax_state):
+        ax.legend(loc="upper left", fontsize="small")
+    if state_names:
+        ax_state.set_yticks(range(len(state_names)))
+        ax_state.set_yticklabels(state_names, fontsize="x-small")
+    ax_state.set_xlabel("time (s)")
+
+    def update(_):
+        for frame in stream.poll():
+            row = dict(zip(COLUMNS, frame_to_row(frame, [])))
+            if writer:
+                writer.writerow(frame_to_row(frame, state_names))
+            data["t"].append(row["time_ms"] / 1000.0)
+            for key in ("period_r", "period_g", "period_b", "motor_left", "motor_right", "distance_cm", "state"):
+                data[key].append(row[key])
+            data["ir"].append(row["ir_left"] + 2 * row["ir_right"])
+            data["battery_mv"] = row["battery_mv"]
+        for key, line in lines.items():
+            line.set_data(data["t"], data[key])
+        for ax in (ax_color, ax_motor, ax_state):
+            ax.relim()
+            ax.autoscale_view()
+        battery = f"{data['battery_mv'] / 1000:.2f} V" if data["battery_mv"] else "n/a"
+        fig.suptitle(f"frames: {stream.frames}  bad: {stream.bad}  battery: {battery}")
+        return list(lines.values())
+
+    _anim = FuncAnimation(fig, update, interval=50, cache_frame_data=False)
+    plt.show()
+
+
+def main():
+    """Open the port, optionally start streaming, then plot and/or log CSV"""
+    import serial  # pyserial
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", required=True, help="Serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--fsm", choices=sorted(STATE_NAMES), help="Name states using this FSM's enum")
+    parser.add_argument("--start", action="store_true", help="Send 't' to toggle streaming on")
+    parser.add_argument("--csv", help="Also write every frame to this CSV file")
+    parser.add_argument("--no-plot", action="store_true", help="Only log CSV (Ctrl+C to stop)")
+    args = parser.parse_args()
+
+    state_names = STATE_NAMES.get(args.fsm, [])
+    csv_file = open(args.csv, "w", newline="") if args.csv else None
+    writer = csv.writer(csv_file) if csv_file else None
+    if writer:
+        writer.writerow(COLUMNS)
+
+    with serial.Serial(args.port, args.baud, timeout=0.05) as ser:
+        if args.start:
+            ser.write(b"t")
+        stream = Stream(ser)
+        try:
+            if args.no_plot:
+                while True:
+                    for frame in stream.poll():
+                        if writer:
+                            writer.writerow(frame_to_row(frame, state_names))
+            else:
+                run_plot(stream, state_names, writer)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            print(f"\n{stream.frames} frames, {stream.bad} bad", file=sys.stderr)
+            if csv_file:
+                csv_file.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,184 @@
+/*
+  Event Queue Stress Test
+  Checks the ISR -> loop() EventQueue under a real interrupt load
+
+  The TCS3200 OUT pin toggles at several kHz, so an interrupt on every
+  edge makes a fast, steady producer. Each event carries a sequence
+  number; loop() drains the queue in batches and checks that:
+  - events arrive in order with non-decreasing timestamps
+  - every missing sequence number is accounted for by the overflow counter
+    (compared whenever the queue has drained, not per batch)
+
+  The queue's own throughput, without the ISR rate limit, is measured by
+  the host stress test in test/host/t_event_queue_host.cpp.
+
+  Hardware Setup:
+  - Color sensor: S0->7, S1->8, S2->9, S3->10, OUT->2 (interrupt pin)
+  - Point the sensor at a bright surface for the highest edge rate
+
+  Usage:
+  1. Upload to Arduino
+  2. Open Serial Monitor (9600 baud)
+  3. Watch the once-per-second report (ERRORS must stay 0)
+  4. Send 's' to toggle a slow consumer (forces overflows)
+  5. Send 'f' to toggle 20% / 100% frequency scaling (edge rate x5)
+*/
+
+#include "color_sensor_func.h"
+#include "event_queue.h"
+
+#define REPORT_INTERVAL 1000  // ms between reports
+#define BATCH_SIZE      8     // events drained per popBatch()
+#define SLOW_CONSUMER_DELAY 20  // ms stall per loop in slow mode
+
+EventQueue<SensorEvent, 64> queue;
+
+// Producer state (ISR only)
+volatile uint8_t isrSequence = 0;
+
+// Consumer state
+uint8_t expectedSequence = 0;
+uint16_t lastOverflows = 0;       // Overflow count at the last settled check
+uint16_t pendingGaps = 0;         // Sequence gaps seen since then
+unsigned long receivedCount = 0;
+unsigned long lostCount = 0;
+unsigned long errorCount = 0;
+unsigned long lastTimeUs = 0;
+unsigned long lastReportTime = 0;
+bool slowConsumer = false;
+bool fullScaling = false;
+
+// ============ PRODUCER (ISR) ============
+
+void onColorEdge() {
+  SensorEvent event;
+  event.timeUs = micros();
+  event.source = EVENT_COLOR_EDGE;
+  event.value = isrSequence++;
+  queue.push(event);
+}
+
+void setup() {
+  Serial.begin(9600);
+  delay(500);
+
+  Serial.println("\n========================================");
+  Serial.println("   EVENT QUEUE STRESS TEST");
+  Serial.println("========================================\n");
+
+  pinMode(PIN_S0, OUTPUT);
+  pinMode(PIN_S1, OUTPUT);
+  pinMode(PIN_S2, OUTPUT);
+  pinMode(PIN_S3, OUTPUT);
+  pinMode(PIN_OUT, INPUT);
+  digitalWrite(PIN_S0, HIGH);
+  digitalWrite(PIN_S1, LOW);
+
+  // Clear filter gives the highest output frequency
+  digitalWrite(PIN_S2, HIGH);
+  digitalWrite(PIN_S3, LOW);
+
+  Serial.println("Commands: 's' slow consumer, 'f' toggle 20%/100% scaling\n");
+
+  lastReportTime = millis();
+  attachInterrupt(digitalPinToInterrupt(PIN_OUT), onColorEdge, CHANGE);
+}
+
+void loop() {
+  if (Serial.available() > 0) {
+    handleCommand(Serial.read());
+  }
+
+  drainQueue();
+
+  if (slowConsumer) {
+    delay(SLOW_CONSUMER_DELAY);
+  }
+
+  if (millis() - lastReportTime >= REPORT_INTERVAL) {
+    printReport(millis() - lastReportTime);
+    lastReportTime = millis();
+  }
+}
+
+// ============ CONSUMER ============
+
+/**
+ * Drain all pending events and check ordering and loss accounting
+ */
+void drainQueue() {
+  SensorEvent batch[BATCH_SIZE];
+  uint8_t n;
+
+  while ((n = queue.popBatch(batch, BATCH_SIZE)) > 0) {
+    for (uint8_t i = 0; i < n; i++) {
+      // Sequence gaps wrap at 256; summed, they stay exact modulo 256
+      pendingGaps += (uint8_t)(batch[i].value - expectedSequence);
+      expectedSequence = batch[i].value + 1;
+
+      if ((long)(batch[i].timeUs - lastTimeUs) < 0 && receivedCount > 0) {
+        errorCount++;  // Timestamps went backwards
+      }
+      lastTimeUs = batch[i].timeUs;
+      receivedCount++;
+    }
+  }
+
+  checkLossAccounting();
+}
+
+/**
+ * Compare the gaps seen against the overflows counted since the last check
+ * A drop is counted when it happens but only shows up as a gap once the
+ * next event is popped, so the two agree only when everything produced has
+ * been consumed: the queue is empty and the ISR's next sequence number is
+ * the one expected. Until then the check waits for a later drain.
+ */
+void checkLossAccounting() {
+  noInterrupts();
+  bool settled = queue.empty() && isrSequence == expectedSequence;
+  uint16_t overflows = queue.overflows();
+  interrupts();
+  if (!settled) {
+    return;
+  }
+
+  uint16_t newOverflows = overflows - lastOverflows;
+  lastOverflows = overflows;
+
+  if (overflows != 0xFFFF && (uint8_t)(pendingGaps - newOverflows) != 0) {
+    errorCount++;
+  }
+  lostCount += newOverflows;
+  pendingGaps = 0;
+}
+
+void printReport(unsigned long elapsedMs) {
+  Serial.print("[EQ] events/s: ");
+  Serial.print(receivedCount * 1000UL / elapsedMs);
+  Serial.print("  lost: ");
+  Serial.print(lostCount);
+  Serial.print("  depth: ");
+  Serial.print(queue.size());
+  Serial.print("  ERRORS: ");
+  Serial.print(errorCount);
+  Serial.println(slowConsumer ? "  (slow consumer)" : "");
+  receivedCount = 0;
+}
+
+void handleCommand(char cmd) {
+  switch (cmd) {
+    case 's':
+    case 'S':
+      slowConsumer = !slowConsumer;
+      Serial.println(slowConsumer ? ">> Slow consumer ON" : ">> Slow consumer OFF");
+      break;
+
+    case 'f':
+    case 'F':
+      fullScaling = !fullScaling;
+      digitalWrite(PIN_S1, fullScaling ? HIGH : LOW);
+      Serial.println(fullScaling ? ">> Scaling 100%" : ">> Scaling 20%");
+      break;
+  }
+}